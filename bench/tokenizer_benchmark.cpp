@@ -0,0 +1,115 @@
+/*
+    Throughput of `Tokenizer` on two generated inputs: short tokens and long strings, symbols and
+    indentation. Not a part of the interpreter, build it by hand from this directory:
+
+        g++ -std=c++20 -O2 -I.. tokenizer_benchmark.cpp ../tokenizer.cpp ../scan_kernels.cpp \
+            ../vector_kernels.cpp -o tokenizer_benchmark
+        ./tokenizer_benchmark [megabytes per input, 100 by default]
+
+    To compare with another revision, build this file against a checkout of it. Revisions before
+    the scan kernels have no `scan_kernels.cpp`:
+
+        git worktree add /tmp/before <revision>
+        g++ -std=c++20 -O2 -I/tmp/before tokenizer_benchmark.cpp /tmp/before/tokenizer.cpp \
+            /tmp/before/vector_kernels.cpp -o tokenizer_benchmark_before
+*/
+
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <variant>
+
+namespace {
+
+constexpr int kRuns = 5;
+
+std::string RandomSymbol(std::mt19937_64& random, size_t length) {
+    static constexpr char kLetters[] = "abcdefghijklmnopqrstuvwxyz-?!*";
+    std::string symbol(1, 'a' + random() % 26);
+    while (symbol.size() < length) {
+        symbol += kLetters[random() % (sizeof(kLetters) - 1)];
+    }
+    return symbol;
+}
+
+std::string GenerateShortTokens(size_t size) {
+    // small lists of short symbols and numbers, about 5.3 bytes per token with the separators
+    std::mt19937_64 random(1);
+    std::string input;
+    input.reserve(size + 64);
+    while (input.size() < size) {
+        input += '(';
+        for (size_t count = 2 + random() % 5; count > 0; --count) {
+            if (random() % 2) {
+                input += std::to_string(random() % 10000000);
+            } else {
+                input += RandomSymbol(random, 3 + random() % 7);
+            }
+            input += ' ';
+        }
+        input.back() = ')';
+        input += random() % 4 ? ' ' : '\n';
+    }
+    return input;
+}
+
+std::string GenerateLongTokens(size_t size) {
+    // indented definitions with long names and string literals, which the scan kernels skip
+    std::mt19937_64 random(2);
+    std::string input;
+    input.reserve(size + 512);
+    while (input.size() < size) {
+        input += "(define " + RandomSymbol(random, 20 + random() % 20);
+        for (size_t count = 1 + random() % 4; count > 0; --count) {
+            input += '\n';
+            input.append(8 + random() % 17, ' ');
+            input += '"';
+            for (size_t length = 40 + random() % 160; length > 0; --length) {
+                input += random() % 8 ? static_cast<char>('a' + random() % 26) : ' ';
+            }
+            input += "\" ";
+            input += std::to_string(random());
+        }
+        input += ")\n\n";
+    }
+    return input;
+}
+
+size_t CountTokens(const std::string& input) {
+    size_t count = 0;
+    Tokenizer tokenizer(input);
+    while (!tokenizer.IsEnd()) {
+        // the token is visited, so that lazily built values are not skipped
+        count += std::visit([](const auto&) { return 1; }, tokenizer.GetToken());
+        tokenizer.Next();
+    }
+    return count;
+}
+
+void Measure(const std::string& name, const std::string& input) {
+    size_t tokens = 0;
+    double best = 1e100;
+    for (int run = 0; run < kRuns; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        tokens = CountTokens(input);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    double megabytes = input.size() / 1e6;
+    std::cout << name << ": " << megabytes << " MB, " << tokens << " tokens, "
+              << input.size() / static_cast<double>(tokens) << " bytes per token, "
+              << megabytes / best << " MB/s (best of " << kRuns << ")\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100) * 1000000;
+    Measure("short tokens", GenerateShortTokens(size));
+    Measure("long strings, symbols, indented", GenerateLongTokens(size));
+}
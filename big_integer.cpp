@@ -0,0 +1,386 @@
+#include "big_integer.h"
+#include "error.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+constexpr uint32_t kDecimalChunk = 1000000000;  // 10^9 fits into one limb
+constexpr size_t kDecimalChunkDigits = 9;
+
+}  // namespace
+
+BigInteger::BigInteger(int64_t value) : negative_(value < 0) {
+    uint64_t magnitude = negative_ ? ~static_cast<uint64_t>(value) + 1 : value;
+    while (magnitude) {
+        magnitude_.push_back(static_cast<Limb>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+BigInteger::BigInteger(bool negative, Limbs magnitude) : magnitude_(std::move(magnitude)) {
+    Trim(magnitude_);
+    negative_ = negative && !magnitude_.empty();
+}
+
+BigInteger BigInteger::FromString(std::string_view str) {
+    bool negative = false;
+    if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+        negative = (str[0] == '-');
+        str.remove_prefix(1);
+    }
+    if (str.empty()) {
+        throw SyntaxError("Integer literal without digits");
+    }
+
+    Limbs magnitude;
+    size_t position = 0;
+    while (position < str.size()) {
+        // first chunk is shorter, so that all others have exactly 9 digits
+        size_t chunk_size = (str.size() - position) % kDecimalChunkDigits;
+        if (chunk_size == 0) {
+            chunk_size = kDecimalChunkDigits;
+        }
+
+        uint64_t multiplier = 1;
+        uint64_t chunk = 0;
+        for (size_t i = 0; i < chunk_size; ++i, ++position) {
+            if (str[position] < '0' || str[position] > '9') {
+                throw SyntaxError("Invalid integer literal: `" + std::string(str) + "`");
+            }
+            chunk = chunk * 10 + (str[position] - '0');
+            multiplier *= 10;
+        }
+
+        uint64_t carry = chunk;
+        for (Limb& limb : magnitude) {
+            uint64_t current = limb * multiplier + carry;
+            limb = static_cast<Limb>(current);
+            carry = current >> 32;
+        }
+        if (carry) {
+            magnitude.push_back(static_cast<Limb>(carry));
+        }
+    }
+
+    return BigInteger(negative, std::move(magnitude));
+}
+
+std::string BigInteger::ToString() const {
+    if (IsZero()) {
+        return "0";
+    }
+
+    std::vector<Limb> chunks;
+    Limbs magnitude = magnitude_;
+    while (!magnitude.empty()) {
+        chunks.push_back(DivideBySmall(magnitude, kDecimalChunk));
+    }
+
+    std::string result = negative_ ? "-" : "";
+    result += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string chunk = std::to_string(chunks[i]);
+        result.append(kDecimalChunkDigits - chunk.size(), '0');
+        result += chunk;
+    }
+    return result;
+}
+
+bool BigInteger::FitsInt64() const {
+    if (magnitude_.size() > 2) {
+        return false;
+    }
+    uint64_t magnitude = 0;
+    for (size_t i = magnitude_.size(); i-- > 0;) {
+        magnitude = (magnitude << 32) | magnitude_[i];
+    }
+    return negative_ ? magnitude <= (uint64_t(1) << 63) : magnitude < (uint64_t(1) << 63);
+}
+
+int64_t BigInteger::ToInt64() const {
+    uint64_t magnitude = 0;
+    for (size_t i = magnitude_.size(); i-- > 0;) {
+        magnitude = (magnitude << 32) | magnitude_[i];
+    }
+    return static_cast<int64_t>(negative_ ? ~magnitude + 1 : magnitude);
+}
+
+double BigInteger::ToDouble() const {
+    double result = 0;
+    for (size_t i = magnitude_.size(); i-- > 0;) {
+        result = result * 4294967296.0 + magnitude_[i];
+    }
+    return negative_ ? -result : result;
+}
+
+size_t BigInteger::Hash() const {
+    size_t hash = negative_;
+    for (Limb limb : magnitude_) {
+        hash = hash * 1000003 + limb;
+    }
+    return hash;
+}
+
+BigInteger BigInteger::operator-() const {
+    return BigInteger(!negative_, magnitude_);
+}
+
+BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs) {
+    using Limbs = BigInteger::Limbs;
+    if (lhs.negative_ == rhs.negative_) {
+        return BigInteger(lhs.negative_, BigInteger::AddMagnitudes(lhs.magnitude_, rhs.magnitude_));
+    }
+    if (BigInteger::CompareMagnitudes(lhs.magnitude_, rhs.magnitude_) >= 0) {
+        return BigInteger(lhs.negative_,
+                          BigInteger::SubtractMagnitudes(lhs.magnitude_, rhs.magnitude_));
+    }
+    Limbs magnitude = BigInteger::SubtractMagnitudes(rhs.magnitude_, lhs.magnitude_);
+    return BigInteger(rhs.negative_, std::move(magnitude));
+}
+
+BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs) {
+    return lhs + (-rhs);
+}
+
+BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs) {
+    return BigInteger(lhs.negative_ != rhs.negative_,
+                      BigInteger::MultiplyMagnitudes(lhs.magnitude_, rhs.magnitude_));
+}
+
+BigInteger operator/(const BigInteger& lhs, const BigInteger& rhs) {
+    if (rhs.IsZero()) {
+        throw RuntimeError("Division by zero");
+    }
+    BigInteger::Limbs quotient;
+    BigInteger::Limbs remainder;
+    BigInteger::DivideMagnitudes(lhs.magnitude_, rhs.magnitude_, &quotient, &remainder);
+    return BigInteger(lhs.negative_ != rhs.negative_, std::move(quotient));
+}
+
+BigInteger operator%(const BigInteger& lhs, const BigInteger& rhs) {
+    if (rhs.IsZero()) {
+        throw RuntimeError("Division by zero");
+    }
+    BigInteger::Limbs quotient;
+    BigInteger::Limbs remainder;
+    BigInteger::DivideMagnitudes(lhs.magnitude_, rhs.magnitude_, &quotient, &remainder);
+    return BigInteger(lhs.negative_, std::move(remainder));
+}
+
+std::strong_ordering operator<=>(const BigInteger& lhs, const BigInteger& rhs) {
+    if (lhs.negative_ != rhs.negative_) {
+        return lhs.negative_ ? std::strong_ordering::less : std::strong_ordering::greater;
+    }
+    int order = BigInteger::CompareMagnitudes(lhs.magnitude_, rhs.magnitude_);
+    if (lhs.negative_) {
+        order = -order;
+    }
+    return order <=> 0;
+}
+
+void BigInteger::Trim(Limbs& limbs) {
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+}
+
+int BigInteger::CompareMagnitudes(const Limbs& lhs, const Limbs& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return lhs.size() < rhs.size() ? -1 : 1;
+    }
+    for (size_t i = lhs.size(); i-- > 0;) {
+        if (lhs[i] != rhs[i]) {
+            return lhs[i] < rhs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+BigInteger::Limbs BigInteger::AddMagnitudes(const Limbs& lhs, const Limbs& rhs) {
+    const Limbs& longer = lhs.size() >= rhs.size() ? lhs : rhs;
+    const Limbs& shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+
+    Limbs result(longer.size() + 1);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < longer.size(); ++i) {
+        uint64_t current = carry + longer[i] + (i < shorter.size() ? shorter[i] : 0);
+        result[i] = static_cast<Limb>(current);
+        carry = current >> 32;
+    }
+    result.back() = static_cast<Limb>(carry);
+    Trim(result);
+    return result;
+}
+
+BigInteger::Limbs BigInteger::SubtractMagnitudes(const Limbs& lhs, const Limbs& rhs) {
+    Limbs result(lhs.size());
+    int64_t borrow = 0;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        int64_t current = int64_t(lhs[i]) - borrow - (i < rhs.size() ? int64_t(rhs[i]) : 0);
+        borrow = current < 0;
+        result[i] = static_cast<Limb>(current + (borrow << 32));
+    }
+    Trim(result);
+    return result;
+}
+
+BigInteger::Limbs BigInteger::MultiplyMagnitudes(const Limbs& lhs, const Limbs& rhs) {
+    if (lhs.empty() || rhs.empty()) {
+        return {};
+    }
+    if (std::min(lhs.size(), rhs.size()) < kKaratsubaThreshold) {
+        return MultiplySchoolbook(lhs, rhs);
+    }
+    return MultiplyKaratsuba(lhs, rhs);
+}
+
+BigInteger::Limbs BigInteger::MultiplySchoolbook(const Limbs& lhs, const Limbs& rhs) {
+    Limbs result(lhs.size() + rhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < rhs.size(); ++j) {
+            uint64_t current = uint64_t(lhs[i]) * rhs[j] + result[i + j] + carry;
+            result[i + j] = static_cast<Limb>(current);
+            carry = current >> 32;
+        }
+        result[i + rhs.size()] = static_cast<Limb>(carry);
+    }
+    Trim(result);
+    return result;
+}
+
+BigInteger::Limbs BigInteger::MultiplyKaratsuba(const Limbs& lhs, const Limbs& rhs) {
+    // lhs = high_l * B^m + low_l, rhs = high_r * B^m + low_r, then
+    // lhs * rhs = z2 * B^2m + (z1 - z2 - z0) * B^m + z0, where
+    // z0 = low_l * low_r, z2 = high_l * high_r, z1 = (low_l + high_l) * (low_r + high_r)
+    size_t half = std::max(lhs.size(), rhs.size()) / 2;
+
+    auto split = [half](const Limbs& limbs) {
+        size_t middle = std::min(half, limbs.size());
+        Limbs low(limbs.begin(), limbs.begin() + middle);
+        Limbs high(limbs.begin() + middle, limbs.end());
+        Trim(low);
+        return std::make_pair(std::move(low), std::move(high));
+    };
+
+    auto [low_l, high_l] = split(lhs);
+    auto [low_r, high_r] = split(rhs);
+
+    Limbs z0 = MultiplyMagnitudes(low_l, low_r);
+    Limbs z2 = MultiplyMagnitudes(high_l, high_r);
+    Limbs z1 = MultiplyMagnitudes(AddMagnitudes(low_l, high_l), AddMagnitudes(low_r, high_r));
+    z1 = SubtractMagnitudes(SubtractMagnitudes(z1, z0), z2);
+
+    Limbs result(lhs.size() + rhs.size() + 1);
+    auto add_shifted = [&result](const Limbs& limbs, size_t shift) {
+        uint64_t carry = 0;
+        size_t i = 0;
+        for (; i < limbs.size(); ++i) {
+            uint64_t current = uint64_t(result[i + shift]) + limbs[i] + carry;
+            result[i + shift] = static_cast<Limb>(current);
+            carry = current >> 32;
+        }
+        for (; carry; ++i) {
+            uint64_t current = uint64_t(result[i + shift]) + carry;
+            result[i + shift] = static_cast<Limb>(current);
+            carry = current >> 32;
+        }
+    };
+    add_shifted(z0, 0);
+    add_shifted(z1, half);
+    add_shifted(z2, 2 * half);
+
+    Trim(result);
+    return result;
+}
+
+BigInteger::Limb BigInteger::DivideBySmall(Limbs& limbs, Limb divisor) {
+    uint64_t remainder = 0;
+    for (size_t i = limbs.size(); i-- > 0;) {
+        uint64_t current = (remainder << 32) | limbs[i];
+        limbs[i] = static_cast<Limb>(current / divisor);
+        remainder = current % divisor;
+    }
+    Trim(limbs);
+    return static_cast<Limb>(remainder);
+}
+
+void BigInteger::DivideMagnitudes(const Limbs& lhs, const Limbs& rhs, Limbs* quotient,
+                                  Limbs* remainder) {
+    if (CompareMagnitudes(lhs, rhs) < 0) {
+        *quotient = {};
+        *remainder = lhs;
+        return;
+    }
+
+    if (rhs.size() == 1) {
+        *quotient = lhs;
+        Limb small_remainder = DivideBySmall(*quotient, rhs[0]);
+        *remainder = small_remainder ? Limbs{small_remainder} : Limbs{};
+        return;
+    }
+
+    // Knuth's algorithm D: divisor is normalized so that its highest bit is set, then every
+    // quotient limb is estimated from the top two limbs and corrected at most twice
+    const size_t n = rhs.size();
+    const size_t m = lhs.size() - n;
+    const int shift = std::countl_zero(rhs.back());
+
+    Limbs divisor(n);
+    Limbs dividend(lhs.size() + 1);
+    for (size_t i = n; i-- > 0;) {
+        divisor[i] = (rhs[i] << shift) | (shift && i ? rhs[i - 1] >> (32 - shift) : 0);
+    }
+    dividend[lhs.size()] = shift ? lhs.back() >> (32 - shift) : 0;
+    for (size_t i = lhs.size(); i-- > 0;) {
+        dividend[i] = (lhs[i] << shift) | (shift && i ? lhs[i - 1] >> (32 - shift) : 0);
+    }
+
+    constexpr uint64_t kBase = uint64_t(1) << 32;
+    quotient->assign(m + 1, 0);
+    for (size_t j = m + 1; j-- > 0;) {
+        uint64_t numerator = (uint64_t(dividend[j + n]) << 32) | dividend[j + n - 1];
+        uint64_t estimate = numerator / divisor[n - 1];
+        uint64_t estimate_remainder = numerator % divisor[n - 1];
+        while (estimate >= kBase ||
+               estimate * divisor[n - 2] > ((estimate_remainder << 32) | dividend[j + n - 2])) {
+            --estimate;
+            estimate_remainder += divisor[n - 1];
+            if (estimate_remainder >= kBase) {
+                break;
+            }
+        }
+
+        int64_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t product = estimate * divisor[i];
+            int64_t current = int64_t(dividend[i + j]) - borrow - int64_t(product & 0xFFFFFFFF);
+            dividend[i + j] = static_cast<Limb>(current);
+            borrow = int64_t(product >> 32) - (current >> 32);
+        }
+        int64_t top = int64_t(dividend[j + n]) - borrow;
+        dividend[j + n] = static_cast<Limb>(top);
+
+        if (top < 0) {
+            // estimate was one too large, adding divisor back
+            --estimate;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t current = uint64_t(dividend[i + j]) + divisor[i] + carry;
+                dividend[i + j] = static_cast<Limb>(current);
+                carry = current >> 32;
+            }
+            dividend[j + n] += static_cast<Limb>(carry);
+        }
+        (*quotient)[j] = static_cast<Limb>(estimate);
+    }
+    Trim(*quotient);
+
+    remainder->assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        (*remainder)[i] = (dividend[i] >> shift) | (shift ? dividend[i + 1] << (32 - shift) : 0);
+    }
+    Trim(*remainder);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class BigInteger {  // arbitrary precision integer, sign and magnitude in base 2^32
+public:
+    constexpr static inline size_t kKaratsubaThreshold = 32;  // in limbs
+
+public:
+    BigInteger() = default;
+    BigInteger(int64_t value);
+
+    static BigInteger FromString(std::string_view str);  // decimal digits with optional sign
+
+    std::string ToString() const;
+
+    bool FitsInt64() const;
+
+    int64_t ToInt64() const;  // assuming the value fits
+
+    double ToDouble() const;
+
+    bool IsZero() const {
+        return magnitude_.empty();
+    }
+
+    bool IsNegative() const {
+        return negative_;
+    }
+
+    size_t Hash() const;
+
+    BigInteger operator-() const;
+
+    friend BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs);
+    friend BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs);
+    friend BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs);
+    friend BigInteger operator/(const BigInteger& lhs, const BigInteger& rhs);  // truncates
+    friend BigInteger operator%(const BigInteger& lhs, const BigInteger& rhs);
+
+    friend std::strong_ordering operator<=>(const BigInteger& lhs, const BigInteger& rhs);
+    friend bool operator==(const BigInteger& lhs, const BigInteger& rhs) = default;
+
+private:
+    using Limb = uint32_t;
+    using Limbs = std::vector<Limb>;
+
+    BigInteger(bool negative, Limbs magnitude);
+
+    static void Trim(Limbs& limbs);
+
+    static int CompareMagnitudes(const Limbs& lhs, const Limbs& rhs);
+
+    static Limbs AddMagnitudes(const Limbs& lhs, const Limbs& rhs);
+
+    static Limbs SubtractMagnitudes(const Limbs& lhs, const Limbs& rhs);  // lhs >= rhs
+
+    static Limbs MultiplyMagnitudes(const Limbs& lhs, const Limbs& rhs);
+
+    static Limbs MultiplySchoolbook(const Limbs& lhs, const Limbs& rhs);
+
+    static Limbs MultiplyKaratsuba(const Limbs& lhs, const Limbs& rhs);
+
+    static Limb DivideBySmall(Limbs& limbs, Limb divisor);  // in place, returns remainder
+
+    static void DivideMagnitudes(const Limbs& lhs, const Limbs& rhs, Limbs* quotient,
+                                 Limbs* remainder);
+
+private:
+    bool negative_ = false;
+    Limbs magnitude_;  // little endian, without leading zeros, empty for zero
+};
@@ -0,0 +1,27 @@
+#include "bytevector.h"
+#include "error.h"
+
+Bytevector::Bytevector(const std::string& path)
+    : mapping_(std::make_unique<MappedFile>(path)) {
+    data_ = const_cast<uint8_t*>(mapping_->GetData());
+    size_ = mapping_->Size();
+}
+
+uint8_t* Bytevector::GetMutableData() {
+    if (mapping_) {
+        throw RuntimeError("Mapped file is read-only");
+    }
+    return data_;
+}
+
+std::string Bytevector::Repr() const {
+    std::string result = "#u8(";
+    for (size_t i = 0; i < size_; ++i) {
+        if (i) {
+            result += ' ';
+        }
+        result += std::to_string(data_[i]);
+    }
+    result += ")";
+    return result;
+}
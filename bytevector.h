@@ -0,0 +1,46 @@
+#pragma once
+
+#include "mapped_file.h"
+#include "object.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Bytevector final : public Object {  // raw bytes, either owned or a read-only file mapping
+public:
+    Bytevector(size_t size, uint8_t fill = 0) : storage_(size, fill) {
+        data_ = storage_.data();
+        size_ = size;
+    }
+
+    Bytevector(const std::string& path);  // maps the file read-only, throws if it cannot
+
+    const uint8_t* GetData() const {
+        return data_;
+    }
+
+    uint8_t* GetMutableData();  // throws for mapped files
+
+    size_t Size() const {
+        return size_;
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override;
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        // a mapping is unmapped once by its only owner, so bytevectors are shared by reference
+        return const_cast<Bytevector*>(this);
+    }
+
+private:
+    std::vector<uint8_t> storage_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::unique_ptr<MappedFile> mapping_;  // set for mapped files, `data_` points into it
+};
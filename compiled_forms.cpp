@@ -0,0 +1,216 @@
+#include "compiled_forms.h"
+#include "garbage_collector.h"
+#include "image_io.h"
+#include "mapped_file.h"
+#include "parallel_reader.h"
+
+#include <unordered_map>
+
+namespace {
+
+constexpr std::string_view kMagic = "SCMC\x01";  // the last byte is the format version
+
+enum Tag : uint8_t {
+    kNil = 0,
+    kFixnum = 1,
+    kFlonum = 2,
+    kBignum = 3,  // decimal digits, they are parsed once on load
+    kString = 4,
+    kSymbol = 5,  // index in the symbol table
+    kList = 6     // length, elements, then the tail, which is `kNil` for proper lists
+};
+
+class ImageWriter {
+public:
+    void WriteForm(Object* obj_ptr) {
+        while (Cell* cell_ptr = As<Cell>(obj_ptr)) {
+            // the spine is written iteratively, only nested lists recurse
+            size_t length = 0;
+            for (Object* it = cell_ptr; Is<Cell>(it); it = As<Cell>(it)->GetSecond()) {
+                ++length;
+            }
+            body_.push_back(kList);
+            WriteVarint(&body_, length);
+            objects_count_ += length;
+            for (size_t i = 0; i < length; ++i) {
+                WriteForm(cell_ptr->GetFirst());
+                obj_ptr = cell_ptr->GetSecond();
+                cell_ptr = As<Cell>(obj_ptr);
+            }
+        }
+        WriteAtom(obj_ptr);
+    }
+
+    std::string Finish(size_t forms_count) const {
+        std::string image(kMagic);
+        WriteVarint(&image, objects_count_);
+        WriteVarint(&image, symbols_.size());
+        for (const std::string* name : symbols_) {
+            WriteBytes(&image, *name);
+        }
+        WriteVarint(&image, forms_count);
+        return image + body_;
+    }
+
+private:
+    void WriteAtom(Object* obj_ptr) {
+        if (!obj_ptr) {
+            body_.push_back(kNil);
+            return;
+        }
+        ++objects_count_;
+        if (Number* number = As<Number>(obj_ptr)) {
+            body_.push_back(kFixnum);
+            WriteFixnum(&body_, number->GetValue());
+        } else if (Flonum* flonum = As<Flonum>(obj_ptr)) {
+            body_.push_back(kFlonum);
+            WriteDouble(&body_, flonum->GetValue());
+        } else if (BigNumber* big_number = As<BigNumber>(obj_ptr)) {
+            body_.push_back(kBignum);
+            WriteBytes(&body_, big_number->GetValue().ToString());
+        } else if (String* string = As<String>(obj_ptr)) {
+            body_.push_back(kString);
+            WriteBytes(&body_, string->GetValue());
+        } else if (Symbol* symbol = As<Symbol>(obj_ptr)) {
+            auto [it, inserted] = symbol_indices_.try_emplace(symbol->GetName(), symbols_.size());
+            if (inserted) {
+                symbols_.push_back(&it->first);
+            }
+            body_.push_back(kSymbol);
+            WriteVarint(&body_, it->second);
+        } else {
+            throw RuntimeError("Cannot compile `" + GetRepr(obj_ptr) + "`, it is not a datum");
+        }
+    }
+
+    std::string body_;
+    size_t objects_count_ = 0;
+    std::unordered_map<std::string, size_t> symbol_indices_;  // nodes are stable, names are shared
+    std::vector<const std::string*> symbols_;
+};
+
+class FormLoader {
+public:
+    FormLoader(ImageReader* reader, std::vector<std::string> symbols)
+        : reader_(reader), symbols_(std::move(symbols)) {
+    }
+
+    Object* LoadForm() {
+        // lists are rebuilt with an explicit stack, like `FormBuilder` does, so nesting depth
+        // is not limited by the native stack
+        while (true) {
+            uint8_t tag = reader_->ReadByte();
+            if (tag == kList) {
+                uint64_t length = reader_->ReadVarint();
+                if (length == 0) {
+                    throw SyntaxError("Compiled image has an empty list node");
+                }
+                stack_.push_back(Frame{.remaining = length});
+                continue;
+            }
+
+            Object* obj_ptr = LoadAtom(tag);
+            while (!stack_.empty()) {
+                Frame& frame = stack_.back();
+                if (frame.remaining == 0) {
+                    frame.last_cell_ptr->GetSecond() = obj_ptr;
+                    obj_ptr = frame.first_cell_ptr;
+                    stack_.pop_back();
+                    continue;
+                }
+                Cell* cell_ptr = garbage_collector::Instance().RegisterObject<Cell>();
+                cell_ptr->GetFirst() = obj_ptr;
+                if (frame.last_cell_ptr) {
+                    frame.last_cell_ptr->GetSecond() = cell_ptr;
+                } else {
+                    frame.first_cell_ptr = cell_ptr;
+                }
+                frame.last_cell_ptr = cell_ptr;
+                --frame.remaining;
+                break;
+            }
+            if (stack_.empty()) {
+                return obj_ptr;
+            }
+        }
+    }
+
+private:
+    struct Frame {
+        Cell* first_cell_ptr = nullptr;
+        Cell* last_cell_ptr = nullptr;
+        uint64_t remaining = 0;  // elements left, the tail follows them
+    };
+
+    Object* LoadAtom(uint8_t tag) {
+        auto& heap = garbage_collector::Instance();
+        switch (tag) {
+            case kNil:
+                return nullptr;
+            case kFixnum:
+                return heap.RegisterObject<Number>(reader_->ReadFixnum());
+            case kFlonum:
+                return heap.RegisterObject<Flonum>(reader_->ReadDouble());
+            case kBignum:
+                return heap.RegisterObject<BigNumber>(BigInteger::FromString(reader_->ReadBytes()));
+            case kString:
+                return heap.RegisterObject<String>(std::string(reader_->ReadBytes()));
+            case kSymbol: {
+                uint64_t index = reader_->ReadVarint();
+                if (index >= symbols_.size()) {
+                    throw SyntaxError("Compiled image refers to an unknown symbol");
+                }
+                return heap.RegisterObject<Symbol>(symbols_[index]);
+            }
+            default:
+                throw SyntaxError("Compiled image has an unknown tag");
+        }
+    }
+
+    ImageReader* reader_;
+    std::vector<std::string> symbols_;
+    std::vector<Frame> stack_;
+};
+
+}  // namespace
+
+std::string CompileForms(std::span<Object* const> forms) {
+    ImageWriter writer;
+    for (Object* form : forms) {
+        writer.WriteForm(form);
+    }
+    return writer.Finish(forms.size());
+}
+
+std::vector<Object*> LoadForms(std::string_view image) {
+    if (!image.starts_with(kMagic)) {
+        throw SyntaxError("Not a compiled image or its version is not supported");
+    }
+    ImageReader reader(image.substr(kMagic.size()));
+    garbage_collector::Instance().Reserve(reader.ReadCount());
+    uint64_t symbols_count = reader.ReadCount();
+    std::vector<std::string> symbols;
+    symbols.reserve(symbols_count);
+    for (uint64_t i = 0; i < symbols_count; ++i) {
+        symbols.emplace_back(reader.ReadBytes());
+    }
+
+    uint64_t forms_count = reader.ReadCount();
+    FormLoader loader(&reader, std::move(symbols));
+    std::vector<Object*> forms;
+    forms.reserve(forms_count);
+    for (uint64_t i = 0; i < forms_count; ++i) {
+        forms.push_back(loader.LoadForm());
+    }
+    if (!reader.IsEnd()) {
+        throw SyntaxError("Compiled image has trailing bytes");
+    }
+    return forms;
+}
+
+size_t CompileFile(const std::string& source_path, const std::string& output_path) {
+    MappedFile source(source_path);
+    std::vector<Object*> forms = ReadAll(source.GetView());
+    WriteImageFile(output_path, CompileForms(forms));
+    return forms.size();
+}
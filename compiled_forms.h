@@ -0,0 +1,19 @@
+#pragma once
+
+#include "object.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    Binary image of forms returned by `Read`: a header with the number of objects to allocate,
+    a table of interned symbol names and the forms, where lists are written as their length,
+    elements and tail. Fixnums are zigzag varints, flonums are raw little-endian doubles
+*/
+std::string CompileForms(std::span<Object* const> forms);  // throws for objects `Read` never makes
+
+std::vector<Object*> LoadForms(std::string_view image);  // throws `SyntaxError` if malformed
+
+size_t CompileFile(const std::string& source_path, const std::string& output_path);  // forms count
@@ -0,0 +1,94 @@
+#include "data_reader.h"
+#include "garbage_collector.h"
+#include "parser.h"
+#include "scope.h"
+#include "tokenizer.h"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+Object* PackedCell::GetBlock() const {
+    return block_;
+}
+
+Object* PackedCell::Copy(std::shared_ptr<Scope> scope) const {
+    // `set-cdr!` may link packed cells of several blocks, all of them are copied into one
+    size_t size = 1;
+    const PackedCell* last_ptr = this;
+    while (const PackedCell* next_ptr = As<PackedCell>(last_ptr->GetSecond())) {
+        last_ptr = next_ptr;
+        ++size;
+    }
+
+    PackedCell* cells = scope->CreateServiceObject<DataBlock>(size)->GetCells();
+    const PackedCell* cell_ptr = this;
+    for (size_t i = 0; i < size; ++i) {
+        cells[i].GetFirst() = CopyObject(cell_ptr->GetFirst(), scope);
+        cells[i].GetSecond() =
+            i + 1 < size ? &cells[i + 1] : CopyObject(last_ptr->GetSecond(), scope);
+        cell_ptr = As<PackedCell>(cell_ptr->GetSecond());
+    }
+    return cells;
+}
+
+namespace {
+
+std::optional<Object*> ReadFlatList(std::string_view source) {
+    // nullopt if the list turns out to be nested or malformed, the general parser handles those
+    Tokenizer tokenizer(source);
+    tokenizer.Next();  // the opening bracket
+    std::vector<Object*> elements;
+    std::unordered_map<std::string_view, Symbol*> symbols;
+    while (!tokenizer.IsEnd()) {
+        Token& token = tokenizer.GetToken();
+        if (BracketToken* bracket = std::get_if<BracketToken>(&token)) {
+            if (*bracket == BracketToken::OPEN) {
+                return std::nullopt;
+            }
+            if (elements.empty()) {
+                return nullptr;
+            }
+            DataBlock* block = garbage_collector::Instance().RegisterObject<DataBlock>(
+                elements.size());
+            PackedCell* cells = block->GetCells();
+            for (size_t i = 0; i < elements.size(); ++i) {
+                cells[i].GetFirst() = elements[i];
+                cells[i].GetSecond() = i + 1 < elements.size() ? &cells[i + 1] : nullptr;
+            }
+            return cells;
+        }
+        if (std::holds_alternative<QuoteToken>(token) || std::holds_alternative<DotToken>(token)) {
+            return std::nullopt;
+        }
+
+        if (SymbolToken* symbol = std::get_if<SymbolToken>(&token)) {
+            // symbols are immutable, so equal ones share an object
+            Symbol*& shared = symbols[symbol->name];
+            if (!shared) {
+                shared = As<Symbol>(CreateAtom(token));
+            }
+            elements.push_back(shared);
+        } else {
+            elements.push_back(CreateAtom(token));
+        }
+        tokenizer.Next();
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+Object* ReadDatum(std::string_view source) {
+    Tokenizer tokenizer(source);
+    if (tokenizer.IsEnd()) {
+        throw RuntimeError("Nothing to read");
+    }
+    BracketToken* bracket = std::get_if<BracketToken>(&tokenizer.GetToken());
+    if (bracket && *bracket == BracketToken::OPEN) {
+        if (std::optional<Object*> list = ReadFlatList(source)) {
+            return *list;
+        }
+    }
+    return Read(&tokenizer);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "object.h"
+
+#include <memory>
+#include <string_view>
+
+class DataBlock;
+
+class PackedCell final : public Cell {  // cell of a list built by `ReadDatum`, owned by its block
+public:
+    Object* GetBlock() const override;
+
+    // copied like any list, but the packed part of the spine goes into one new block
+    Object* Copy(std::shared_ptr<Scope> scope) const override;
+
+private:
+    friend class DataBlock;
+
+    DataBlock* block_ = nullptr;
+};
+
+class DataBlock final : public Object {  // cells of one read list in a single allocation
+public:
+    DataBlock(size_t size) : cells_(std::make_unique<PackedCell[]>(size)) {
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].block_ = this;
+        }
+    }
+
+    PackedCell* GetCells() {
+        return cells_.get();
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override {
+        return "#<data-block>";
+    }
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<DataBlock*>(this);
+    }
+
+private:
+    std::unique_ptr<PackedCell[]> cells_;
+};
+
+/*
+    Reads the first datum of the source. Flat lists of atoms take the fast path: their cells are
+    allocated as one block and equal symbols share one object. Anything nested is read by the
+    general parser
+*/
+Object* ReadDatum(std::string_view source);
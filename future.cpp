@@ -0,0 +1,82 @@
+#include "future.h"
+
+FutureState::FutureState(Object* expression, std::shared_ptr<Scope> snapshot,
+                         TaskScheduler* scheduler)
+    : expression_(expression), snapshot_(std::move(snapshot)), tasks_(scheduler) {
+}
+
+void FutureState::Start(std::shared_ptr<FutureState> self) {
+    // the task keeps the state alive, even if the future is collected before it is over
+    tasks_.Submit([self = std::move(self)] { self->Run(); });
+}
+
+void FutureState::Run() {
+    Object* value = nullptr;
+    std::exception_ptr error;
+    {
+        garbage_collector::HeapBinding binding(&heap_);
+        // `define` and `set!` of the expression change its own copy of the bindings, the snapshot
+        // is read by the collector of another thread meanwhile
+        std::shared_ptr<Scope> frame = snapshot_->Snapshot();
+        try {
+            value = EvaluateObject(expression_, frame);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    std::lock_guard lock(mutex_);
+    value_ = value;
+    error_ = error;
+    done_ = true;
+    snapshot_.reset();  // only the value is kept alive from now on
+}
+
+Object* FutureState::Touch() {
+    tasks_.Wait();
+    std::lock_guard lock(mutex_);
+    if (!merged_) {
+        garbage_collector::Instance().Merge(heap_);
+        merged_ = true;
+    }
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    return value_;
+}
+
+void FutureState::Abandon() {
+    std::lock_guard lock(mutex_);
+    abandoned_ = true;
+}
+
+void FutureState::GatherSubobjects(std::set<Object*>& save) {
+    // the value may refer to objects of the collected heap before it is touched
+    std::lock_guard lock(mutex_);
+    if (done_) {
+        if (value_) {
+            value_->GatherSubobjects(save);
+        }
+        return;
+    }
+    if (expression_) {
+        expression_->GatherSubobjects(save);
+    }
+    for (const auto& [name, obj_ptr] : snapshot_->GetObjectsInThisScope()) {
+        if (obj_ptr) {
+            obj_ptr->GatherSubobjects(save);
+        }
+    }
+}
+
+bool FutureState::TryRelease(garbage_collector::GarbageCollector* heap) {
+    // a touched value is kept by the future, an abandoned one is garbage
+    std::lock_guard lock(mutex_);
+    if (!done_ || !(merged_ || abandoned_)) {
+        return false;
+    }
+    if (!merged_) {
+        heap->Merge(heap_);
+        merged_ = true;
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "garbage_collector.h"
+#include "object.h"
+#include "scope.h"
+#include "task_scheduler.h"
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <set>
+
+class FutureState final : public garbage_collector::HeapRoot {
+    /*
+        Expression evaluated by a task of the scheduler in a snapshot of the variables. The task
+        allocates into a heap of its own, which is merged into the heap of the first `Touch`
+        caller, so the value is published only to a thread which waited for it
+    */
+public:
+    FutureState(Object* expression, std::shared_ptr<Scope> snapshot, TaskScheduler* scheduler);
+
+    void Start(std::shared_ptr<FutureState> self);
+
+    Object* Touch();  // waits for the value, rethrows the error of the expression
+
+    void Abandon();  // nothing refers to the future, the value is never touched
+
+    void GatherSubobjects(std::set<Object*>& save) override;
+
+    bool TryRelease(garbage_collector::GarbageCollector* heap) override;
+
+    void Wait() override {
+        tasks_.Wait();
+    }
+
+private:
+    void Run();
+
+    Object* expression_;
+    std::shared_ptr<Scope> snapshot_;
+    garbage_collector::GarbageCollector heap_;
+    TaskGroup tasks_;
+
+    std::mutex mutex_;
+    bool done_ = false;
+    bool merged_ = false;
+    bool abandoned_ = false;
+    Object* value_ = nullptr;
+    std::exception_ptr error_;
+};
+
+class Future final : public Object {  // made by `(future expr)`, shared by reference like vectors
+public:
+    Future(std::shared_ptr<FutureState> state) : state_(std::move(state)) {
+    }
+
+    ~Future() override {
+        state_->Abandon();
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override {
+        return "#<future>";
+    }
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<Future*>(this);
+    }
+
+    void GatherSubobjects(std::set<Object*>& save) override {
+        if (save.insert(this).second) {
+            state_->GatherSubobjects(save);
+        }
+    }
+
+    Object* Touch() {
+        return state_->Touch();
+    }
+
+private:
+    std::shared_ptr<FutureState> state_;
+};
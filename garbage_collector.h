@@ -2,15 +2,40 @@
 
 #include "abstract_object.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <set>
 
 namespace garbage_collector {
 
-class GarbageCollector {  // singleton
+class GarbageCollector;
+
+class HeapRoot {  // work which runs on another thread and uses objects of the heap
 public:
-    GarbageCollector() = default;
+    virtual void GatherSubobjects(std::set<Object*>& save) = 0;
+
+    virtual bool TryRelease(GarbageCollector* heap) = 0;
+    /*
+        True once the work is over and nothing of it needs to be kept as a root, the objects it
+        allocated which are not merged yet go to `heap`
+    */
+
+    virtual void Wait() = 0;
+
+    virtual ~HeapRoot() = default;
+};
+
+class GarbageCollector {  // one per interpreter, objects never refer to another heap
+public:
+    GarbageCollector() : epoch_(NextEpoch()) {
+    }
+
+    GarbageCollector(const GarbageCollector&) = delete;
+    GarbageCollector& operator=(const GarbageCollector&) = delete;
 
     template <class T, class... Args>
     T* RegisterObject(Args&&... args) {
@@ -20,6 +45,10 @@ public:
     }
 
     void CollectExcept(std::set<Object*> leave_ptrs) {
+        std::erase_if(roots_, [&](const auto& root) { return root->TryRelease(this); });
+        for (const auto& root : roots_) {
+            root->GatherSubobjects(leave_ptrs);
+        }
         std::vector<Object*> new_objects;
         for (auto obj_ptr : objects_) {
             if (!leave_ptrs.contains(obj_ptr)) {
@@ -29,21 +58,84 @@ public:
             }
         }
         objects_ = new_objects;
+        epoch_ = NextEpoch();
+    }
+
+    void Reserve(size_t count) {  // for loaders which know the number of objects in advance
+        objects_.reserve(objects_.size() + count);
+    }
+
+    void AddRoot(std::shared_ptr<HeapRoot> root) {  // kept until it is released
+        roots_.push_back(std::move(root));
+    }
+
+    void Merge(GarbageCollector& other) {  // takes over every object and root of `other`
+        objects_.insert(objects_.end(), other.objects_.begin(), other.objects_.end());
+        other.objects_.clear();
+        roots_.insert(roots_.end(), other.roots_.begin(), other.roots_.end());
+        other.roots_.clear();
+    }
+
+    size_t Size() const {  // registered objects, alive or not
+        return objects_.size();
+    }
+
+    uint64_t Epoch() const {
+        /*
+            Changes on every collection and differs between heaps, so caches keyed by addresses may
+            be shared by all heaps of a thread: no address is reused within one epoch
+        */
+        return epoch_;
     }
 
     ~GarbageCollector() {
+        for (const auto& root : roots_) {  // the work may still use objects of the heap
+            root->Wait();
+        }
         for (auto obj_ptr : objects_) {
             delete obj_ptr;
         }
     }
 
 private:
+    static uint64_t NextEpoch() {
+        static std::atomic<uint64_t> next_epoch = 1;
+        return next_epoch.fetch_add(1, std::memory_order_relaxed);
+    }
+
     std::vector<Object*> objects_;
+    std::vector<std::shared_ptr<HeapRoot>> roots_;
+    uint64_t epoch_;
 };
 
-static inline GarbageCollector& Instance() {
-    static GarbageCollector gc;
-    return gc;
+inline GarbageCollector*& ThreadHeap() {  // set by `HeapBinding`
+    thread_local GarbageCollector* heap = nullptr;
+    return heap;
 }
 
+inline GarbageCollector& Instance() {  // the bound heap, or the own heap of the thread
+    if (GarbageCollector* heap = ThreadHeap()) {
+        return *heap;
+    }
+    thread_local GarbageCollector heap;
+    return heap;
+}
+
+class HeapBinding {  // allocations of the thread go to `heap` while the binding exists
+public:
+    HeapBinding(GarbageCollector* heap) : previous_(ThreadHeap()) {
+        ThreadHeap() = heap;
+    }
+
+    HeapBinding(const HeapBinding&) = delete;
+    HeapBinding& operator=(const HeapBinding&) = delete;
+
+    ~HeapBinding() {
+        ThreadHeap() = previous_;
+    }
+
+private:
+    GarbageCollector* previous_;
+};
+
 }  // namespace garbage_collector
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "hash_table.h"
+
+#include <bit>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+uint32_t MatchByte(const int8_t* group, int8_t value) {
+    // bit `i` is set if control byte `i` of the group is equal to `value`
+#ifdef __SSE2__
+    __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(value)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < HashTable::kGroupSize; ++i) {
+        mask |= uint32_t(group[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+uint32_t MatchEmptyOrDeleted(const int8_t* group) {
+    // both special control bytes are negative, full ones are not
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < HashTable::kGroupSize; ++i) {
+        mask |= uint32_t(group[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+size_t MixHash(size_t hash) {
+    // structural hashes of small numbers are the numbers themselves, so bits are spread before
+    // splitting the hash into group index and control byte
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+}  // namespace
+
+Object* HashTable::Find(Object* key) const {
+    auto index = FindSlot(key, Hash(key));
+    return index ? slots_[*index].value : nullptr;
+}
+
+bool HashTable::Contains(Object* key) const {
+    return FindSlot(key, Hash(key)).has_value();
+}
+
+void HashTable::Insert(Object* key, Object* value) {
+    size_t hash = Hash(key);
+    if (auto index = FindSlot(key, hash)) {
+        slots_[*index].value = value;
+        return;
+    }
+
+    // load factor including tombstones is kept below 7/8
+    if ((size_ + deleted_ + 1) * 8 > control_.size() * 7) {
+        size_t capacity = control_.empty() ? kGroupSize : control_.size();
+        if ((size_ + 1) * 16 > capacity * 7) {
+            capacity *= 2;
+        }
+        Rehash(capacity);
+    }
+
+    size_t index = FindInsertSlot(hash);
+    if (control_[index] == kDeleted) {
+        --deleted_;
+    }
+    control_[index] = static_cast<int8_t>(hash & 0x7F);
+    slots_[index] = Slot{key, value};
+    ++size_;
+}
+
+bool HashTable::Erase(Object* key) {
+    auto index = FindSlot(key, Hash(key));
+    if (!index) {
+        return false;
+    }
+    control_[*index] = kDeleted;
+    slots_[*index] = Slot{};
+    --size_;
+    ++deleted_;
+    return true;
+}
+
+void HashTable::GatherSubobjects(std::set<Object*>& save) {
+    if (!save.insert(this).second) {
+        return;
+    }
+    ForEach([&](Object* key, Object* value) {
+        if (key) {
+            key->GatherSubobjects(save);
+        }
+        if (value) {
+            value->GatherSubobjects(save);
+        }
+    });
+}
+
+size_t HashTable::Hash(Object* key) const {
+    if (equivalence_ == Equivalence::Eqv && key && !IsComparedByValue(key)) {
+        return MixHash(std::hash<Object*>{}(key));
+    }
+    return MixHash(HashObject(key));
+}
+
+bool HashTable::KeysEqual(Object* lhs, Object* rhs) const {
+    return equivalence_ == Equivalence::Eqv ? EqvObjects(lhs, rhs) : EqualObjects(lhs, rhs);
+}
+
+std::optional<size_t> HashTable::FindSlot(Object* key, size_t hash) const {
+    if (control_.empty()) {
+        return std::nullopt;
+    }
+
+    const size_t groups_count = control_.size() / kGroupSize;
+    const int8_t control_byte = static_cast<int8_t>(hash & 0x7F);
+    size_t group = (hash >> 7) & (groups_count - 1);
+    for (size_t probe = 1; probe <= groups_count; ++probe) {
+        const int8_t* group_control = control_.data() + group * kGroupSize;
+        for (uint32_t mask = MatchByte(group_control, control_byte); mask; mask &= mask - 1) {
+            size_t index = group * kGroupSize + std::countr_zero(mask);
+            if (KeysEqual(slots_[index].key, key)) {
+                return index;
+            }
+        }
+        if (MatchByte(group_control, kEmpty)) {
+            return std::nullopt;  // the key would have been inserted here
+        }
+        group = (group + probe) & (groups_count - 1);  // triangular probing visits every group
+    }
+    return std::nullopt;
+}
+
+size_t HashTable::FindInsertSlot(size_t hash) const {
+    const size_t groups_count = control_.size() / kGroupSize;
+    size_t group = (hash >> 7) & (groups_count - 1);
+    for (size_t probe = 1;; ++probe) {
+        if (uint32_t mask = MatchEmptyOrDeleted(control_.data() + group * kGroupSize)) {
+            return group * kGroupSize + std::countr_zero(mask);
+        }
+        group = (group + probe) & (groups_count - 1);
+    }
+}
+
+void HashTable::Rehash(size_t new_capacity) {
+    std::vector<int8_t> old_control = std::move(control_);
+    std::vector<Slot> old_slots = std::move(slots_);
+
+    control_.assign(new_capacity, kEmpty);
+    slots_.assign(new_capacity, Slot{});
+    deleted_ = 0;
+
+    for (size_t i = 0; i < old_slots.size(); ++i) {
+        if (IsFull(old_control[i])) {
+            size_t hash = Hash(old_slots[i].key);
+            size_t index = FindInsertSlot(hash);
+            control_[index] = static_cast<int8_t>(hash & 0x7F);
+            slots_[index] = old_slots[i];
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "object.h"
+
+#include <cstdint>
+#include <vector>
+
+class HashTable final : public Object {  // open addressing table with SIMD probing of groups
+public:
+    enum class Equivalence {
+        Eqv = 0,   // numbers, booleans and symbols by value, everything else by identity
+        Equal = 1  // structural, like `EqualObjects`
+    };
+
+    constexpr static inline size_t kGroupSize = 16;
+
+public:
+    HashTable(Equivalence equivalence = Equivalence::Equal) : equivalence_(equivalence) {
+    }
+
+    Object* Find(Object* key) const;  // nullptr if there is no such key
+
+    bool Contains(Object* key) const;
+
+    void Insert(Object* key, Object* value);
+
+    bool Erase(Object* key);
+
+    size_t Size() const {
+        return size_;
+    }
+
+    Equivalence GetEquivalence() const {
+        return equivalence_;
+    }
+
+    template <class F>
+    void ForEach(F&& function) const {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (IsFull(control_[i])) {
+                function(slots_[i].key, slots_[i].value);
+            }
+        }
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override {
+        return "#<hash-table>";
+    }
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<HashTable*>(this);  // shared by reference, like vectors
+    }
+
+    void GatherSubobjects(std::set<Object*>& save) override;
+
+private:
+    struct Slot {
+        Object* key = nullptr;
+        Object* value = nullptr;
+    };
+
+    /*
+        Control byte of every slot is either empty, deleted or 7 low bits of the key hash, so one
+        SIMD comparison filters 16 candidates at once
+    */
+    constexpr static inline int8_t kEmpty = -128;
+    constexpr static inline int8_t kDeleted = -2;
+
+    static bool IsFull(int8_t control) {
+        return control >= 0;
+    }
+
+    size_t Hash(Object* key) const;
+
+    bool KeysEqual(Object* lhs, Object* rhs) const;
+
+    std::optional<size_t> FindSlot(Object* key, size_t hash) const;
+
+    size_t FindInsertSlot(size_t hash) const;
+
+    void Rehash(size_t new_capacity);
+
+private:
+    Equivalence equivalence_;
+    size_t size_ = 0;
+    size_t deleted_ = 0;
+    std::vector<int8_t> control_;  // capacity is zero or a power of two, multiple of group size
+    std::vector<Slot> slots_;
+};
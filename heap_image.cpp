@@ -0,0 +1,375 @@
+#include "heap_image.h"
+#include "bytevector.h"
+#include "garbage_collector.h"
+#include "hash_table.h"
+#include "image_io.h"
+#include "memoized_function.h"
+
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view kMagic = "SCMH\x01";  // the last byte is the format version
+
+enum Tag : uint8_t {
+    kNumber = 0,
+    kBigNumber = 1,
+    kFlonum = 2,
+    kBoolean = 3,
+    kSymbol = 4,
+    kString = 5,
+    kStringBuilder = 6,
+    kCell = 7,
+    kVector = 8,
+    kBytevector = 9,  // mapped files are saved by contents and restored as owned bytes
+    kHashTable = 10,
+    kScopedFunction = 11,
+    kMemoizedFunction = 12,
+    kBuiltin = 13  // name in the builtins of the loading interpreter
+};
+
+class HeapWriter {
+public:
+    HeapWriter(const Bindings& builtins) {
+        for (const auto& [name, obj_ptr] : builtins) {
+            builtin_names_.emplace(obj_ptr, name);
+        }
+    }
+
+    std::string Write(const Bindings& bindings) {
+        std::string tail;
+        WriteVarint(&tail, bindings.size());
+        for (const auto& [name, obj_ptr] : bindings) {
+            WriteBytes(&tail, name);
+            WriteVarint(&tail, Index(obj_ptr));
+        }
+
+        // records are written in index order, objects they refer to are appended to the queue,
+        // so the traversal is breadth-first and long lists do not recurse
+        for (size_t i = 0; i < objects_.size(); ++i) {
+            WriteRecord(objects_[i]);
+        }
+
+        std::string image(kMagic);
+        WriteVarint(&image, objects_.size());
+        return image + body_ + tail;
+    }
+
+private:
+    uint64_t Index(Object* obj_ptr) {  // zero is the empty list
+        if (!obj_ptr) {
+            return 0;
+        }
+        auto [it, inserted] = indices_.try_emplace(obj_ptr, objects_.size() + 1);
+        if (inserted) {
+            objects_.push_back(obj_ptr);
+        }
+        return it->second;
+    }
+
+    void WriteReference(Object* obj_ptr) {
+        WriteVarint(&body_, Index(obj_ptr));
+    }
+
+    void WriteRecord(Object* obj_ptr) {
+        if (auto it = builtin_names_.find(obj_ptr); it != builtin_names_.end()) {
+            body_.push_back(kBuiltin);
+            WriteBytes(&body_, it->second);
+        } else if (Number* number = As<Number>(obj_ptr)) {
+            body_.push_back(kNumber);
+            WriteFixnum(&body_, number->GetValue());
+        } else if (BigNumber* big_number = As<BigNumber>(obj_ptr)) {
+            body_.push_back(kBigNumber);
+            WriteBytes(&body_, big_number->GetValue().ToString());
+        } else if (Flonum* flonum = As<Flonum>(obj_ptr)) {
+            body_.push_back(kFlonum);
+            WriteDouble(&body_, flonum->GetValue());
+        } else if (Boolean* boolean = As<Boolean>(obj_ptr)) {
+            body_.push_back(kBoolean);
+            body_.push_back(boolean->GetValue());
+        } else if (Symbol* symbol = As<Symbol>(obj_ptr)) {
+            body_.push_back(kSymbol);
+            WriteBytes(&body_, symbol->GetName());
+        } else if (String* string = As<String>(obj_ptr)) {
+            body_.push_back(kString);
+            WriteBytes(&body_, string->GetValue());
+        } else if (StringBuilder* builder = As<StringBuilder>(obj_ptr)) {
+            body_.push_back(kStringBuilder);
+            WriteBytes(&body_, builder->GetBuffer());
+        } else if (Cell* cell_ptr = As<Cell>(obj_ptr)) {
+            body_.push_back(kCell);
+            WriteReference(cell_ptr->GetFirst());
+            WriteReference(cell_ptr->GetSecond());
+        } else if (Vector* vector = As<Vector>(obj_ptr)) {
+            body_.push_back(kVector);
+            WriteVarint(&body_, vector->GetElements().size());
+            for (Object* element : vector->GetElements()) {
+                WriteReference(element);
+            }
+        } else if (Bytevector* bytevector = As<Bytevector>(obj_ptr)) {
+            body_.push_back(kBytevector);
+            const char* data = reinterpret_cast<const char*>(bytevector->GetData());
+            WriteBytes(&body_, std::string_view(data, bytevector->Size()));
+        } else if (HashTable* table = As<HashTable>(obj_ptr)) {
+            body_.push_back(kHashTable);
+            body_.push_back(static_cast<char>(table->GetEquivalence()));
+            WriteVarint(&body_, table->Size());
+            table->ForEach([&](Object* key, Object* value) {
+                WriteReference(key);
+                WriteReference(value);
+            });
+        } else if (ScopedFunction* function = As<ScopedFunction>(obj_ptr)) {
+            WriteScopedFunction(function);
+        } else if (MemoizedFunction* memoized = As<MemoizedFunction>(obj_ptr)) {
+            auto [it, inserted] = caches_.try_emplace(&memoized->GetCache(), caches_.size());
+            body_.push_back(kMemoizedFunction);
+            WriteReference(memoized->GetFunction());
+            WriteVarint(&body_, it->second);
+            WriteVarint(&body_, memoized->GetCache().Capacity());
+        } else {
+            throw RuntimeError("Cannot save `" + GetRepr(obj_ptr) + "` to an image");
+        }
+    }
+
+    void WriteScopedFunction(ScopedFunction* function) {
+        body_.push_back(kScopedFunction);
+        std::optional<size_t> args_count = function->ExpectedArgumentsCounter();
+        WriteVarint(&body_, args_count ? *args_count + 1 : 0);
+        WriteVarint(&body_, function->GetArgumentNames().size());
+        for (const std::string& name : function->GetArgumentNames()) {
+            WriteBytes(&body_, name);
+        }
+        WriteVarint(&body_, function->GetCommands().size());
+        for (Object* command : function->GetCommands()) {
+            WriteReference(command);
+        }
+        WriteVarint(&body_, function->GetCapturedVariables().size());
+        for (const auto& [name, obj_ptr] : function->GetCapturedVariables()) {
+            WriteBytes(&body_, name);
+            WriteReference(obj_ptr);
+        }
+    }
+
+    std::unordered_map<Object*, std::string> builtin_names_;
+    std::unordered_map<Object*, uint64_t> indices_;
+    std::vector<Object*> objects_;  // in index order, starting with one
+    std::unordered_map<const MemoCache*, uint64_t> caches_;
+    std::string body_;
+};
+
+class HeapLoader {
+public:
+    HeapLoader(ImageReader* reader, const Bindings& builtins)
+        : reader_(reader), builtins_(builtins) {
+    }
+
+    Bindings Load() {
+        uint64_t objects_count = reader_->ReadCount();
+        garbage_collector::Instance().Reserve(objects_count);
+        objects_.assign(objects_count + 1, nullptr);
+        for (uint64_t index = 1; index <= objects_count; ++index) {
+            objects_[index] = LoadRecord(index);
+        }
+
+        CreateMemoized();
+        for (auto [slot, index] : fixups_) {
+            *slot = objects_[index];
+        }
+        // keys are hashed by contents, so tables are filled once every object is complete
+        for (auto& [table, entries] : tables_) {
+            for (auto [key_index, value_index] : entries) {
+                table->Insert(objects_[key_index], objects_[value_index]);
+            }
+        }
+
+        Bindings bindings;
+        uint64_t bindings_count = reader_->ReadCount();
+        for (uint64_t i = 0; i < bindings_count; ++i) {
+            std::string name(reader_->ReadBytes());
+            bindings[std::move(name)] = objects_[ReadIndex()];
+        }
+        if (!reader_->IsEnd()) {
+            throw SyntaxError("Image has trailing bytes");
+        }
+        return bindings;
+    }
+
+private:
+    using IndexPair = std::pair<uint64_t, uint64_t>;
+
+    struct PendingMemoized {
+        uint64_t index;
+        uint64_t function_index;
+        std::shared_ptr<MemoCache> cache;
+    };
+
+    void CreateMemoized() {
+        // a memoized function may wrap another one, which has to be created first whatever
+        // order they were discovered in
+        std::unordered_map<uint64_t, const PendingMemoized*> pending;
+        for (const PendingMemoized& memoized : memoized_) {
+            pending[memoized.index] = &memoized;
+        }
+        for (const PendingMemoized& memoized : memoized_) {
+            std::vector<const PendingMemoized*> chain;  // each one wraps the next
+            for (auto it = pending.find(memoized.index); it != pending.end();) {
+                chain.push_back(it->second);
+                pending.erase(it);  // a cycle stops here and is reported below
+                it = pending.find(chain.back()->function_index);
+            }
+            auto& heap = garbage_collector::Instance();
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                Function* function = As<Function>(objects_[(*it)->function_index]);
+                if (!function) {
+                    throw SyntaxError("Image has a memoized function which wraps no function");
+                }
+                objects_[(*it)->index] =
+                    heap.RegisterObject<MemoizedFunction>(function, (*it)->cache);
+            }
+        }
+    }
+
+    uint64_t ReadIndex() {
+        uint64_t index = reader_->ReadVarint();
+        if (index >= objects_.size()) {
+            throw SyntaxError("Image refers to a missing object");
+        }
+        return index;
+    }
+
+    void ReadReference(Object** slot) {  // patched once every object is allocated
+        fixups_.emplace_back(slot, ReadIndex());
+    }
+
+    Object* LoadRecord(uint64_t index) {
+        auto& heap = garbage_collector::Instance();
+        switch (reader_->ReadByte()) {
+            case kNumber:
+                return heap.RegisterObject<Number>(reader_->ReadFixnum());
+            case kBigNumber:
+                return heap.RegisterObject<BigNumber>(BigInteger::FromString(reader_->ReadBytes()));
+            case kFlonum:
+                return heap.RegisterObject<Flonum>(reader_->ReadDouble());
+            case kBoolean:
+                return GetBooleanConstant(reader_->ReadByte());
+            case kSymbol:
+                return heap.RegisterObject<Symbol>(std::string(reader_->ReadBytes()));
+            case kString:
+                return heap.RegisterObject<String>(std::string(reader_->ReadBytes()));
+            case kStringBuilder: {
+                StringBuilder* builder = heap.RegisterObject<StringBuilder>();
+                builder->GetBuffer() = reader_->ReadBytes();
+                return builder;
+            }
+            case kCell: {
+                Cell* cell_ptr = heap.RegisterObject<Cell>();
+                ReadReference(&cell_ptr->GetFirst());
+                ReadReference(&cell_ptr->GetSecond());
+                return cell_ptr;
+            }
+            case kVector: {
+                Vector* vector = heap.RegisterObject<Vector>();
+                vector->GetElements().resize(reader_->ReadCount());
+                for (Object*& element : vector->GetElements()) {
+                    ReadReference(&element);
+                }
+                return vector;
+            }
+            case kBytevector: {
+                std::string_view bytes = reader_->ReadBytes();
+                Bytevector* bytevector = heap.RegisterObject<Bytevector>(bytes.size());
+                std::memcpy(bytevector->GetMutableData(), bytes.data(), bytes.size());
+                return bytevector;
+            }
+            case kHashTable:
+                return LoadHashTable();
+            case kScopedFunction:
+                return LoadScopedFunction();
+            case kMemoizedFunction: {
+                uint64_t function_index = ReadIndex();
+                uint64_t cache_index = reader_->ReadCount();
+                size_t capacity = reader_->ReadVarint();
+                std::shared_ptr<MemoCache>& cache = caches_[cache_index];
+                if (!cache) {
+                    cache = std::make_shared<MemoCache>(capacity);
+                }
+                memoized_.push_back(PendingMemoized{index, function_index, cache});
+                return nullptr;  // created once the wrapped function exists
+            }
+            case kBuiltin: {
+                auto it = builtins_.find(std::string(reader_->ReadBytes()));
+                if (it == builtins_.end()) {
+                    throw SyntaxError("Image refers to an unknown builtin");
+                }
+                return it->second;
+            }
+            default:
+                throw SyntaxError("Image has an unknown tag");
+        }
+    }
+
+    Object* LoadHashTable() {
+        uint8_t equivalence = reader_->ReadByte();
+        if (equivalence > static_cast<uint8_t>(HashTable::Equivalence::Equal)) {
+            throw SyntaxError("Image has a hash table with unknown equivalence");
+        }
+        HashTable* table = garbage_collector::Instance().RegisterObject<HashTable>(
+            static_cast<HashTable::Equivalence>(equivalence));
+        std::vector<IndexPair>& entries = tables_.emplace_back(table, 0).second;
+        entries.resize(reader_->ReadCount());
+        for (auto& [key_index, value_index] : entries) {
+            key_index = ReadIndex();
+            value_index = ReadIndex();
+        }
+        return table;
+    }
+
+    Object* LoadScopedFunction() {
+        uint64_t args_count = reader_->ReadVarint();
+        std::vector<std::string> names(reader_->ReadCount());
+        for (std::string& name : names) {
+            name = reader_->ReadBytes();
+        }
+        ScopedFunction* function = garbage_collector::Instance().RegisterObject<ScopedFunction>(
+            names, std::vector<Object*>(), std::unordered_map<std::string, Object*>(),
+            args_count ? std::optional<size_t>(args_count - 1) : std::nullopt);
+
+        function->GetCommands().resize(reader_->ReadCount());
+        for (Object*& command : function->GetCommands()) {
+            ReadReference(&command);
+        }
+        uint64_t captures_count = reader_->ReadCount();
+        for (uint64_t i = 0; i < captures_count; ++i) {
+            std::string name(reader_->ReadBytes());
+            // nodes of the map are stable, so its values can be patched later
+            ReadReference(&function->GetCapturedVariables()[std::move(name)]);
+        }
+        return function;
+    }
+
+    ImageReader* reader_;
+    const Bindings& builtins_;
+    std::vector<Object*> objects_;  // zero is the empty list
+    std::vector<std::pair<Object**, uint64_t>> fixups_;
+    std::vector<std::pair<HashTable*, std::vector<IndexPair>>> tables_;  // keys and values
+    std::vector<PendingMemoized> memoized_;
+    std::unordered_map<uint64_t, std::shared_ptr<MemoCache>> caches_;
+};
+
+}  // namespace
+
+std::string WriteHeapImage(const Bindings& bindings, const Bindings& builtins) {
+    return HeapWriter(builtins).Write(bindings);
+}
+
+Bindings ReadHeapImage(std::string_view image, const Bindings& builtins) {
+    if (!image.starts_with(kMagic)) {
+        throw SyntaxError("Not a heap image or its version is not supported");
+    }
+    ImageReader reader(image.substr(kMagic.size()));
+    return HeapLoader(&reader, builtins).Load();
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "object.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using Bindings = std::unordered_map<std::string, Object*>;
+
+/*
+    Image of variables and every object reachable from them, including bodies and captures of
+    lambdas. Objects are records which refer to each other by index, so the image does not depend
+    on addresses: loading allocates every object first and then patches the references. Builtins
+    are written by the name they are registered under in `builtins`, memoization caches keep their
+    capacity and sharing, but start empty
+*/
+std::string WriteHeapImage(const Bindings& bindings, const Bindings& builtins);
+
+Bindings ReadHeapImage(std::string_view image, const Bindings& builtins);  // throws if malformed
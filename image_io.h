@@ -0,0 +1,112 @@
+#pragma once
+
+#include "error.h"
+
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+// little-endian base-128 varints and length-prefixed byte strings shared by binary images
+
+inline void WriteVarint(std::string* out, uint64_t value) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+}
+
+inline void WriteBytes(std::string* out, std::string_view bytes) {
+    WriteVarint(out, bytes.size());
+    *out += bytes;
+}
+
+inline void WriteFixnum(std::string* out, int64_t value) {  // zigzag, small magnitudes are short
+    WriteVarint(out, (static_cast<uint64_t>(value) << 1) ^ (value < 0 ? ~uint64_t{0} : 0));
+}
+
+inline void WriteDouble(std::string* out, double value) {
+    uint64_t bits = std::bit_cast<uint64_t>(value);
+    for (size_t i = 0; i < sizeof(bits); ++i) {
+        out->push_back(static_cast<char>(bits >> (8 * i)));
+    }
+}
+
+inline void WriteImageFile(const std::string& path, std::string_view image) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.write(image.data(), image.size()) || !out.flush()) {
+        throw RuntimeError("Cannot write `" + path + "`: " + std::strerror(errno));
+    }
+}
+
+class ImageReader {  // throws `SyntaxError` instead of reading past the end
+public:
+    ImageReader(std::string_view image) : image_(image) {
+    }
+
+    uint8_t ReadByte() {
+        if (position_ >= image_.size()) {
+            throw SyntaxError("Image is truncated");
+        }
+        return static_cast<uint8_t>(image_[position_++]);
+    }
+
+    uint64_t ReadVarint() {
+        uint64_t value = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = ReadByte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw SyntaxError("Image has a malformed varint");
+    }
+
+    int64_t ReadFixnum() {
+        uint64_t value = ReadVarint();
+        return static_cast<int64_t>((value >> 1) ^ -(value & 1));
+    }
+
+    double ReadDouble() {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < sizeof(bits); ++i) {
+            bits |= static_cast<uint64_t>(ReadByte()) << (8 * i);
+        }
+        return std::bit_cast<double>(bits);
+    }
+
+    std::string_view ReadBytes(size_t size) {
+        if (size > image_.size() - position_) {
+            throw SyntaxError("Image is truncated");
+        }
+        std::string_view bytes = image_.substr(position_, size);
+        position_ += size;
+        return bytes;
+    }
+
+    std::string_view ReadBytes() {
+        return ReadBytes(ReadVarint());
+    }
+
+    uint64_t ReadCount() {  // every counted item takes at least a byte, so it cannot be huge
+        uint64_t count = ReadVarint();
+        if (count > image_.size()) {
+            throw SyntaxError("Image has a malformed count");
+        }
+        return count;
+    }
+
+    bool IsEnd() const {
+        return position_ == image_.size();
+    }
+
+private:
+    std::string_view image_;
+    size_t position_ = 0;
+};
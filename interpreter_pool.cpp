@@ -0,0 +1,74 @@
+#include "interpreter_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+InterpreterPool::InterpreterPool(size_t threads_count,
+                                 const std::function<void(Interpreter&)>& setup,
+                                 size_t queue_capacity)
+    : requests_(queue_capacity),
+      free_slots_(static_cast<std::ptrdiff_t>(queue_capacity)),
+      ready_requests_(0) {
+    if (!threads_count) {
+        threads_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    // interpreters are set up by the caller, so errors of `setup` are thrown from here
+    auto builtins = std::make_shared<const Builtins>();
+    for (size_t i = 0; i < threads_count; ++i) {
+        interpreters_.push_back(std::make_unique<Interpreter>(builtins));
+        if (setup) {
+            setup(*interpreters_.back());
+        }
+    }
+    for (auto& interpreter : interpreters_) {
+        workers_.emplace_back(&InterpreterPool::Work, this, interpreter.get());
+    }
+}
+
+InterpreterPool::~InterpreterPool() {
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        Request request;
+        request.stop = true;
+        Push(std::move(request));
+    }
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::future<std::string> InterpreterPool::Submit(std::string command) {
+    Request request;
+    request.command = std::move(command);
+    std::future<std::string> result = request.result.get_future();
+    Push(std::move(request));
+    return result;
+}
+
+void InterpreterPool::Push(Request request) {
+    free_slots_.acquire();
+    // the semaphore counts finished pops, the slot at the tail may still be taken by a running one
+    while (!requests_.TryPush(request)) {
+        std::this_thread::yield();
+    }
+    ready_requests_.release();
+}
+
+void InterpreterPool::Work(Interpreter* interpreter) {
+    while (true) {
+        ready_requests_.acquire();
+        std::optional<Request> request;
+        while (!(request = requests_.TryPop())) {  // the push may be not over yet
+            std::this_thread::yield();
+        }
+        free_slots_.release();
+        if (request->stop) {
+            return;
+        }
+        try {
+            request->result.set_value(interpreter->Run(request->command));
+        } catch (...) {
+            request->result.set_exception(std::current_exception());
+        }
+    }
+}
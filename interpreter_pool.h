@@ -0,0 +1,55 @@
+#pragma once
+
+#include "mpmc_queue.h"
+#include "scheme.h"
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+class InterpreterPool {
+    /*
+        Serves requests on worker threads, every worker owns an interpreter with a heap of its own,
+        and the builtins are shared by all of them. A request goes to any free worker, so
+        definitions made by one request are not seen by the others, unless they are made by
+        `setup`, which runs on every interpreter before the first request
+    */
+public:
+    explicit InterpreterPool(size_t threads_count = 0,  // zero means one per hardware thread
+                             const std::function<void(Interpreter&)>& setup = {},
+                             size_t queue_capacity = 1024);
+
+    InterpreterPool(const InterpreterPool&) = delete;
+    InterpreterPool& operator=(const InterpreterPool&) = delete;
+
+    ~InterpreterPool();  // requests submitted before are served first
+
+    std::future<std::string> Submit(std::string command);
+    /*
+        The result is what `Interpreter::Run` returns, or its exception. Blocks only while the
+        queue is full
+    */
+
+private:
+    struct Request {
+        std::string command;
+        std::promise<std::string> result;
+        bool stop = false;  // the worker which takes it exits
+    };
+
+    void Push(Request request);
+
+    void Work(Interpreter* interpreter);
+
+private:
+    MpmcQueue<Request> requests_;
+    std::counting_semaphore<> free_slots_;  // idle threads sleep on these, the queue never blocks
+    std::counting_semaphore<> ready_requests_;
+    std::vector<std::unique_ptr<Interpreter>> interpreters_;
+    std::vector<std::thread> workers_;
+};
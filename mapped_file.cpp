@@ -0,0 +1,45 @@
+#include "mapped_file.h"
+#include "error.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw RuntimeError("Cannot open `" + path + "`: " + std::strerror(errno));
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        int error = errno;
+        close(fd);
+        throw RuntimeError("Cannot stat `" + path + "`: " + std::strerror(error));
+    }
+
+    size_ = info.st_size;
+    if (size_ == 0) {  // empty mappings are not allowed
+        close(fd);
+        return;
+    }
+
+    void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    close(fd);  // the mapping keeps the file alive
+    if (address == MAP_FAILED) {
+        throw RuntimeError("Cannot map `" + path + "`: " + std::strerror(error));
+    }
+    madvise(address, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<uint8_t*>(address);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        munmap(data_, size_);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class MappedFile {  // read-only private mapping of a whole file, unmapped on destruction
+public:
+    MappedFile(const std::string& path);  // throws `RuntimeError` if the file cannot be mapped
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    const uint8_t* GetData() const {
+        return data_;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    std::string_view GetView() const {
+        return std::string_view(reinterpret_cast<const char*>(data_), size_);
+    }
+
+private:
+    uint8_t* data_ = nullptr;  // nullptr for empty files, they cannot be mapped
+    size_t size_ = 0;
+};
@@ -0,0 +1,103 @@
+#include "memoized_function.h"
+#include "error.h"
+
+std::optional<Object*> MemoCache::Find(const std::vector<Object*>& arguments) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(&arguments);
+    if (it == index_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->value;
+}
+
+void MemoCache::Insert(std::vector<Object*> arguments, Object* value) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(&arguments);
+    if (it != index_.end()) {
+        // the same arguments may be computed twice by a recursive call
+        it->second->value = value;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    entries_.push_front(Entry{std::move(arguments), value});
+    index_[&entries_.front().arguments] = entries_.begin();
+
+    while (entries_.size() > capacity_) {
+        index_.erase(&entries_.back().arguments);
+        entries_.pop_back();
+    }
+}
+
+void MemoCache::GatherSubobjects(std::set<Object*>& save) {
+    // objects are gathered without the lock, a cached value may refer to this cache again
+    std::vector<Object*> objects;
+    {
+        std::lock_guard lock(mutex_);
+        for (Entry& entry : entries_) {
+            objects.insert(objects.end(), entry.arguments.begin(), entry.arguments.end());
+            objects.push_back(entry.value);
+        }
+    }
+    for (Object* obj_ptr : objects) {
+        if (obj_ptr) {
+            obj_ptr->GatherSubobjects(save);
+        }
+    }
+}
+
+size_t MemoCache::ArgumentsHash::operator()(const std::vector<Object*>* arguments) const {
+    size_t hash = arguments->size();
+    for (Object* obj_ptr : *arguments) {
+        hash = hash * 1000003 + HashObject(obj_ptr);
+    }
+    return hash;
+}
+
+bool MemoCache::ArgumentsEqual::operator()(const std::vector<Object*>* lhs,
+                                           const std::vector<Object*>* rhs) const {
+    if (lhs->size() != rhs->size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs->size(); ++i) {
+        if (!EqualObjects((*lhs)[i], (*rhs)[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Object* MemoizedFunction::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> arguments;
+    ApplyToList(cell_ptr,
+                [&](Object* obj_ptr) { arguments.push_back(EvaluateObject(obj_ptr, scope)); });
+    return Apply(arguments, scope);
+}
+
+Object* MemoizedFunction::Apply(const std::vector<Object*>& arguments,
+                                std::shared_ptr<Scope> scope) {
+    if (auto cached = cache_->Find(arguments)) {
+        return *cached;
+    }
+
+    Object* result = function_->Apply(arguments, scope);
+
+    // arguments are copied, so that later `set-car!` on them cannot change the key
+    std::vector<Object*> key;
+    for (Object* obj_ptr : arguments) {
+        key.push_back(CopyObject(obj_ptr, scope));
+    }
+    cache_->Insert(std::move(key), result);
+    return result;
+}
+
+void MemoizedFunction::GatherSubobjects(std::set<Object*>& save) {
+    if (!save.insert(this).second) {
+        return;
+    }
+    function_->GatherSubobjects(save);
+    cache_->GatherSubobjects(save);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "object.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+class MemoCache {  // LRU cache from argument lists to results of a pure function, thread safe
+public:
+    constexpr static inline size_t kDefaultCapacity = 1024;
+
+public:
+    MemoCache(size_t capacity = kDefaultCapacity) : capacity_(capacity) {
+    }
+
+    std::optional<Object*> Find(const std::vector<Object*>& arguments);
+    /*
+        Counts hit or miss, found entry becomes the most recently used one
+    */
+
+    void Insert(std::vector<Object*> arguments, Object* value);
+
+    size_t Hits() const {
+        std::lock_guard lock(mutex_);
+        return hits_;
+    }
+
+    size_t Misses() const {
+        std::lock_guard lock(mutex_);
+        return misses_;
+    }
+
+    size_t Size() const {
+        std::lock_guard lock(mutex_);
+        return entries_.size();
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+    void GatherSubobjects(std::set<Object*>& save);
+
+private:
+    struct Entry {
+        std::vector<Object*> arguments;
+        Object* value;
+    };
+
+    struct ArgumentsHash {
+        size_t operator()(const std::vector<Object*>* arguments) const;
+    };
+
+    struct ArgumentsEqual {
+        bool operator()(const std::vector<Object*>* lhs, const std::vector<Object*>* rhs) const;
+    };
+
+private:
+    mutable std::mutex mutex_;  // calls may run in parallel by `pmap` and futures
+    size_t capacity_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    std::list<Entry> entries_;  // most recently used first
+    std::unordered_map<const std::vector<Object*>*, std::list<Entry>::iterator, ArgumentsHash,
+                       ArgumentsEqual>
+        index_;  // keys point to arguments stored in `entries_`
+};
+
+class MemoizedFunction final : public Function {
+public:
+    MemoizedFunction(Function* function, std::shared_ptr<MemoCache> cache)
+        : Function(function->ExpectedArgumentsCounter()), function_(function), cache_(cache) {
+    }
+
+    std::shared_ptr<Scope> Setup(Cell*, std::shared_ptr<Scope> scope) override {
+        return scope;
+    }
+
+    void Teardown(std::shared_ptr<Scope>) override {
+    }
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+
+    Object* Apply(const std::vector<Object*>& arguments, std::shared_ptr<Scope> scope) override;
+
+    Object* Copy(std::shared_ptr<Scope> scope) const override {
+        // copies share the cache, so the statistics do not depend on where the function is stored
+        return scope->CreateServiceObject<MemoizedFunction>(function_, cache_);
+    }
+
+    void GatherSubobjects(std::set<Object*>& save) override;
+
+    const MemoCache& GetCache() const {
+        return *cache_;
+    }
+
+    Function* GetFunction() const {
+        return function_;
+    }
+
+private:
+    Function* function_;
+    std::shared_ptr<MemoCache> cache_;
+};
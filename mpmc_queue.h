@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+template <class T>
+class MpmcQueue {
+    /*
+        Bounded lock-free queue for many producers and consumers. Every slot has a sequence
+        number, which tells whether the slot is free for the push at a position or holds the value
+        for the pop at it, so producers and consumers only race for positions with one CAS each
+    */
+public:
+    explicit MpmcQueue(size_t capacity)  // rounded up to a power of two
+        : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+          slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryPush(T& value) {  // false if the queue is full, `value` is moved out only on success
+        size_t position = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[position & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (tail_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position) {  // the pop of the previous round is not over
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> TryPop() {  // nullopt if the queue is empty
+        size_t position = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[position & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position + 1) {
+                if (head_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+                    std::optional<T> value = std::move(slot.value);
+                    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return value;
+                }
+            } else if (sequence < position + 1) {  // the push to this position is not over
+                return std::nullopt;
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    constexpr static inline size_t kCacheLineSize = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(kCacheLineSize) std::atomic<size_t> tail_ = 0;  // producers and consumers do not
+    alignas(kCacheLineSize) std::atomic<size_t> head_ = 0;  // share a cache line
+};
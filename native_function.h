@@ -0,0 +1,176 @@
+#pragma once
+
+#include "standart_functions.h"
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+    Conversion of a C++ type from arguments and into results, `FromObject` throws `RuntimeError`
+    if the object has another type. Integers are fixnums, `double` accepts any number
+*/
+template <class T>
+struct NativeType;
+
+template <>
+struct NativeType<int64_t> {
+    static int64_t FromObject(Object* obj_ptr) {
+        return GetNumberValue(obj_ptr);
+    }
+
+    static Object* ToObject(int64_t value, std::shared_ptr<Scope> scope) {
+        return CreateNumber(value, scope);
+    }
+};
+
+template <>
+struct NativeType<double> {
+    static double FromObject(Object* obj_ptr) {
+        return GetFlonumValue(obj_ptr);
+    }
+
+    static Object* ToObject(double value, std::shared_ptr<Scope> scope) {
+        return scope->CreateServiceObject<Flonum>(value);
+    }
+};
+
+template <>
+struct NativeType<bool> {
+    static bool FromObject(Object* obj_ptr) {
+        return !IsFalse(obj_ptr);
+    }
+
+    static Object* ToObject(bool value, std::shared_ptr<Scope>) {
+        return GetBooleanConstant(value);
+    }
+};
+
+template <>
+struct NativeType<std::string> {
+    static const std::string& FromObject(Object* obj_ptr) {  // not copied for reference parameters
+        return GetStringValue(obj_ptr);
+    }
+
+    static Object* ToObject(std::string value, std::shared_ptr<Scope> scope) {
+        return scope->CreateServiceObject<String>(std::move(value));
+    }
+};
+
+template <>
+struct NativeType<std::string_view> {
+    static std::string_view FromObject(Object* obj_ptr) {
+        return GetStringValue(obj_ptr);
+    }
+
+    static Object* ToObject(std::string_view value, std::shared_ptr<Scope> scope) {
+        return scope->CreateServiceObject<String>(std::string(value));
+    }
+};
+
+template <>
+struct NativeType<Object*> {  // any value, passed as is
+    static Object* FromObject(Object* obj_ptr) {
+        return obj_ptr;
+    }
+
+    static Object* ToObject(Object* obj_ptr, std::shared_ptr<Scope>) {
+        return obj_ptr;
+    }
+};
+
+template <class F>
+struct NativeSignature : NativeSignature<decltype(&F::operator())> {};  // lambdas and functors
+
+template <class R, class... Args>
+struct NativeSignature<R (*)(Args...)> {
+    using Type = R(Args...);
+};
+
+template <class C, class R, class... Args>
+struct NativeSignature<R (C::*)(Args...) const> : NativeSignature<R (*)(Args...)> {};
+
+template <class C, class R, class... Args>
+struct NativeSignature<R (C::*)(Args...)> : NativeSignature<R (*)(Args...)> {};
+
+template <class Derived, size_t ArgsCount>
+class NativeFunctionBase : public StandartFunction {};
+
+template <class Derived>
+class NativeFunctionBase<Derived, 2> : public BinaryFunction {  // gets the fast path of `(f a b)`
+public:
+    Object* InvokeBinary(Object* lhs, Object* rhs, std::shared_ptr<Scope> scope) override {
+        Object* arguments[] = {lhs, rhs};
+        return static_cast<Derived*>(this)->InvokeEvaluated(arguments, scope);
+    }
+};
+
+template <class F, class Signature = typename NativeSignature<F>::Type>
+class NativeFunction;
+
+template <class F, class R, class... Args>
+class NativeFunction<F, R(Args...)> final
+    : public NativeFunctionBase<NativeFunction<F, R(Args...)>, sizeof...(Args)> {
+public:
+    constexpr static inline size_t kArgsCount = sizeof...(Args);
+
+public:
+    NativeFunction(F function) : function_(std::move(function)) {
+    }
+
+    std::optional<size_t> ExpectedArgumentsCounter() const override {
+        // the base has no arity, so `Call` does not walk the arguments list once more
+        return kArgsCount;
+    }
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override {
+        std::array<Object*, kArgsCount> arguments;
+        for (Object*& argument : arguments) {
+            if (!cell_ptr) {
+                throw RuntimeError("Wrong number of arguments");
+            }
+            argument = EvaluateObject(cell_ptr->GetFirst(), scope);
+            cell_ptr = As<Cell>(cell_ptr->GetSecond());
+        }
+        if (cell_ptr) {
+            throw RuntimeError("Wrong number of arguments");
+        }
+        return InvokeEvaluated(arguments.data(), scope);
+    }
+
+    Object* Apply(const std::vector<Object*>& arguments, std::shared_ptr<Scope> scope) override {
+        // arguments are already evaluated, so they are converted without quoting
+        if (arguments.size() != kArgsCount) {
+            throw RuntimeError("Wrong number of arguments");
+        }
+        return InvokeEvaluated(arguments.data(), scope);
+    }
+
+    Object* InvokeEvaluated(Object* const* arguments, std::shared_ptr<Scope> scope) {
+        return Invoke(arguments, scope, std::index_sequence_for<Args...>());
+    }
+
+private:
+    template <size_t... I>
+    Object* Invoke(Object* const* arguments, std::shared_ptr<Scope>& scope,
+                   std::index_sequence<I...>) {
+        // braced initialization converts the arguments from left to right
+        std::tuple<decltype(NativeType<std::decay_t<Args>>::FromObject(nullptr))...> values{
+            NativeType<std::decay_t<Args>>::FromObject(arguments[I])...};
+        if constexpr (std::is_void_v<R>) {
+            std::apply(function_, std::move(values));
+            return nullptr;
+        } else {
+            return NativeType<std::decay_t<R>>::ToObject(std::apply(function_, std::move(values)),
+                                                         scope);
+        }
+    }
+
+    F function_;
+};
@@ -1,5 +1,9 @@
 #include "object.h"
 #include "error.h"
+#include "printer.h"
+
+#include <charconv>
+#include <cmath>
 
 Cell* FormList(Object* obj_ptr, std::shared_ptr<Scope> scope) {
     if (!obj_ptr) {
@@ -32,12 +36,34 @@ std::shared_ptr<Scope> ScopedFunction::Setup(Cell* cell_ptr, std::shared_ptr<Sco
         throw RuntimeError("Not enough arguments for lambda");
     }
 
+    NameCapturedVariables(new_scope);
+    return new_scope;
+}
+
+void ScopedFunction::NameCapturedVariables(std::shared_ptr<Scope> scope) {
     // registered capture clause
     for (auto& [name, obj_ptr] : captured_variables_) {
-        new_scope->NameObject(obj_ptr, name);
+        scope->NameObject(obj_ptr, name);
     }
+}
 
-    return new_scope;
+Object* ScopedFunction::Apply(const std::vector<Object*>& arguments,
+                              std::shared_ptr<Scope> scope) {
+    // same as `Setup`, but arguments are bound without evaluation
+    if (arguments.size() > argnames_.size()) {
+        throw RuntimeError("Too many arguments for lambda");
+    }
+    if (arguments.size() < argnames_.size()) {
+        throw RuntimeError("Not enough arguments for lambda");
+    }
+
+    std::shared_ptr<Scope> new_scope = std::make_shared<Scope>(scope.get());
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        new_scope->NameObject(CopyObject(arguments[i], new_scope), argnames_[i]);
+    }
+    NameCapturedVariables(new_scope);
+
+    return InvokeImpl(nullptr, new_scope);
 }
 
 Object* ScopedFunction::InvokeImpl(Cell*, std::shared_ptr<Scope> scope) {
@@ -51,9 +77,19 @@ Object* ScopedFunction::InvokeImpl(Cell*, std::shared_ptr<Scope> scope) {
 }
 
 void ScopedFunction::Teardown(std::shared_ptr<Scope> scope) {
-    // grab capture clause back
+    // grab capture clause back, only changed values are written, so that calls of a function
+    // which does not `set!` its captures may run on several threads at once
     for (auto& [name, obj_ptr] : captured_variables_) {
-        obj_ptr = *scope->GetObjectInThisScope(name);
+        Object* value = *scope->GetObjectInThisScope(name);
+        if (value != obj_ptr) {
+            obj_ptr = value;
+        }
+    }
+}
+
+void ScopedFunction::Recapture(const std::string& name, Object* obj_ptr) {
+    if (auto it = captured_variables_.find(name); it != captured_variables_.end()) {
+        it->second = obj_ptr;
     }
 }
 
@@ -66,9 +102,24 @@ Object* Function::Call(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
     return result;
 }
 
+Object* Function::Apply(const std::vector<Object*>& arguments, std::shared_ptr<Scope> scope) {
+    // arguments are evaluated once again by `Call`, so everything that does not evaluate to
+    // itself has to be quoted
+    std::vector<Object*> quoted_arguments;
+    for (Object* obj_ptr : arguments) {
+        if (!obj_ptr || Is<Cell>(obj_ptr) || Is<Symbol>(obj_ptr)) {
+            quoted_arguments.push_back(VectorToProperList(
+                {scope->CreateServiceObject<Symbol>("quote"), obj_ptr}, scope));
+        } else {
+            quoted_arguments.push_back(obj_ptr);
+        }
+    }
+    return Call(VectorToProperList(quoted_arguments, scope), scope);
+}
+
 Object* Symbol::Evaluate(std::shared_ptr<Scope> scope) {
     if (name_ == "#t" || name_ == "#f") {
-        return scope->CreateServiceObject<Boolean>(name_);
+        return GetBooleanConstant(name_ == "#t");
     } else {
         // TODO: here may be variable
         auto obj = scope->GetObjectInAncestorScope(name_);
@@ -80,29 +131,65 @@ Object* Symbol::Evaluate(std::shared_ptr<Scope> scope) {
     }
 }
 
+std::string Flonum::Repr() const {
+    if (std::isnan(number_)) {
+        return "+nan.0";
+    }
+    if (std::isinf(number_)) {
+        return number_ > 0 ? "+inf.0" : "-inf.0";
+    }
+
+    char buffer[32];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), number_);
+    std::string result(buffer, end);
+    if (result.find_first_of(".e") == std::string::npos) {
+        result += ".0";  // inexact numbers are always printed with fraction or exponent
+    }
+    return result;
+}
+
 std::string Cell::Repr() const {
-    std::string result = "(";
-    const Cell* cell_ptr = this;
+    return PrintToString(const_cast<Cell*>(this));
+}
 
-    while (true) {
-        result += GetRepr(cell_ptr->GetFirst());
-        if (!cell_ptr->GetSecond()) {
-            break;
+std::string String::Repr() const {
+    std::string result = "\"";
+    result.reserve(value_.size() + 2);
+    for (char ch : value_) {
+        switch (ch) {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                result += ch;
         }
+    }
+    result += '"';
+    return result;
+}
 
-        result += ' ';
+std::string Vector::Repr() const {
+    return PrintToString(const_cast<Vector*>(this));
+}
 
-        if (Is<Cell>(cell_ptr->GetSecond())) {
-            cell_ptr = As<Cell>(cell_ptr->GetSecond());
-        } else {
-            result += ". ";
-            result += GetRepr(cell_ptr->GetSecond());
-            break;
+void Vector::GatherSubobjects(std::set<Object*>& save) {
+    if (!save.insert(this).second) {
+        return;
+    }
+    for (Object* obj_ptr : elements_) {
+        if (obj_ptr) {
+            obj_ptr->GatherSubobjects(save);
         }
     }
-
-    result += ")";
-    return result;
 }
 
 Object* Cell::Evaluate(std::shared_ptr<Scope> scope) {
@@ -130,14 +217,33 @@ Object* Cell::Evaluate(std::shared_ptr<Scope> scope) {
         next_cell = FormList(GetSecond(), scope);
     }
 
+    if (BinaryFunction* binary_ptr = As<BinaryFunction>(func)) {
+        Cell* last_cell = next_cell ? As<Cell>(next_cell->GetSecond()) : nullptr;
+        if (last_cell && !last_cell->GetSecond()) {
+            return binary_ptr->InvokeBinary(EvaluateObject(next_cell->GetFirst(), scope),
+                                            EvaluateObject(last_cell->GetFirst(), scope), scope);
+        }
+    }
+
     return func->Call(next_cell, scope);
 }
 
 Object* Cell::Copy(std::shared_ptr<Scope> scope) const {
-    Cell* cell_ptr = scope->CreateServiceObject<Cell>();
-    cell_ptr->GetFirst() = CopyObject(GetFirst(), scope);
-    cell_ptr->GetSecond() = CopyObject(GetSecond(), scope);
-    return cell_ptr;
+    // the spine is copied iteratively, a tail which is not a plain cell copies itself
+    Cell* first_cell_ptr = scope->CreateServiceObject<Cell>();
+    Cell* new_cell_ptr = first_cell_ptr;
+    const Cell* cell_ptr = this;
+    while (true) {
+        new_cell_ptr->GetFirst() = CopyObject(cell_ptr->GetFirst(), scope);
+        const Cell* next_ptr = As<Cell>(cell_ptr->GetSecond());
+        if (!next_ptr || next_ptr->GetBlock()) {
+            new_cell_ptr->GetSecond() = CopyObject(cell_ptr->GetSecond(), scope);
+            return first_cell_ptr;
+        }
+        new_cell_ptr->GetSecond() = scope->CreateServiceObject<Cell>();
+        new_cell_ptr = As<Cell>(new_cell_ptr->GetSecond());
+        cell_ptr = next_ptr;
+    }
 }
 
 Object* ScopedFunction::Copy(std::shared_ptr<Scope> scope) const {
@@ -214,26 +320,166 @@ bool IsBooleanConstant(Object* obj_ptr) {
     return (repr == "#t" || repr == "#f");
 }
 
+Boolean* GetBooleanConstant(bool value) {
+    // constants are not registered in the collector, nothing ever changes them
+    static Boolean true_constant(true);
+    static Boolean false_constant(false);
+    return value ? &true_constant : &false_constant;
+}
+
+Number* CreateNumber(int64_t value, std::shared_ptr<Scope> scope) {
+    constexpr int64_t kMinShared = -128;
+    constexpr int64_t kMaxShared = 1023;
+
+    struct SharedNumbers {
+        SharedNumbers() {
+            for (int64_t value = kMinShared; value <= kMaxShared; ++value) {
+                numbers[value - kMinShared].Set(value);
+            }
+        }
+
+        Number numbers[kMaxShared - kMinShared + 1];
+    };
+
+    // loop counters and indices are small, sharing them saves an allocation per operation
+    static SharedNumbers shared;
+    if (kMinShared <= value && value <= kMaxShared) {
+        return &shared.numbers[value - kMinShared];
+    }
+    return scope->CreateServiceObject<Number>(value);
+}
+
+Object* CreateInteger(BigInteger value, std::shared_ptr<Scope> scope) {
+    if (value.FitsInt64()) {
+        return CreateNumber(value.ToInt64(), scope);
+    }
+    return scope->CreateServiceObject<BigNumber>(std::move(value));
+}
+
 Object* CopyObject(Object* obj_ptr, std::shared_ptr<Scope> scope) {
     return obj_ptr ? obj_ptr->Copy(scope) : nullptr;
 }
 
+size_t HashObject(Object* obj_ptr) {
+    size_t hash = 0;
+    while (Is<Cell>(obj_ptr)) {
+        // lists are hashed by their elements, the spine is walked iteratively
+        hash = hash * 1000003 + HashObject(As<Cell>(obj_ptr)->GetFirst());
+        obj_ptr = As<Cell>(obj_ptr)->GetSecond();
+    }
+
+    size_t tail_hash = 0;
+    if (!obj_ptr) {
+        tail_hash = 0;
+    } else if (Number* number_ptr = As<Number>(obj_ptr)) {
+        tail_hash = std::hash<int64_t>{}(number_ptr->GetValue());
+    } else if (BigNumber* big_number_ptr = As<BigNumber>(obj_ptr)) {
+        tail_hash = big_number_ptr->GetValue().Hash();
+    } else if (Flonum* flonum_ptr = As<Flonum>(obj_ptr)) {
+        tail_hash = std::hash<double>{}(flonum_ptr->GetValue());
+    } else if (String* string_ptr = As<String>(obj_ptr)) {
+        tail_hash = std::hash<std::string>{}(string_ptr->GetValue());
+    } else if (Vector* vector_ptr = As<Vector>(obj_ptr)) {
+        tail_hash = vector_ptr->GetElements().size();
+        for (Object* element : vector_ptr->GetElements()) {
+            tail_hash = tail_hash * 1000003 + HashObject(element);
+        }
+    } else if (Symbol* symbol_ptr = As<Symbol>(obj_ptr)) {
+        tail_hash = std::hash<std::string>{}(symbol_ptr->GetName());
+    } else if (Boolean* boolean_ptr = As<Boolean>(obj_ptr)) {
+        tail_hash = boolean_ptr->GetValue() ? 1 : 2;
+    } else {
+        tail_hash = std::hash<Object*>{}(obj_ptr);
+    }
+    return hash * 1000003 + tail_hash;
+}
+
+bool EqualObjects(Object* lhs, Object* rhs) {
+    while (Is<Cell>(lhs) && Is<Cell>(rhs)) {
+        if (!EqualObjects(As<Cell>(lhs)->GetFirst(), As<Cell>(rhs)->GetFirst())) {
+            return false;
+        }
+        lhs = As<Cell>(lhs)->GetSecond();
+        rhs = As<Cell>(rhs)->GetSecond();
+    }
+
+    if (!lhs || !rhs) {
+        return lhs == rhs;
+    } else if (Is<Number>(lhs) && Is<Number>(rhs)) {
+        return As<Number>(lhs)->GetValue() == As<Number>(rhs)->GetValue();
+    } else if (Is<BigNumber>(lhs) && Is<BigNumber>(rhs)) {
+        return As<BigNumber>(lhs)->GetValue() == As<BigNumber>(rhs)->GetValue();
+    } else if (Is<Flonum>(lhs) && Is<Flonum>(rhs)) {
+        return As<Flonum>(lhs)->GetValue() == As<Flonum>(rhs)->GetValue();
+    } else if (Is<String>(lhs) && Is<String>(rhs)) {
+        return As<String>(lhs)->GetValue() == As<String>(rhs)->GetValue();
+    } else if (Is<Vector>(lhs) && Is<Vector>(rhs)) {
+        const auto& lhs_elements = As<Vector>(lhs)->GetElements();
+        const auto& rhs_elements = As<Vector>(rhs)->GetElements();
+        if (lhs_elements.size() != rhs_elements.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs_elements.size(); ++i) {
+            if (!EqualObjects(lhs_elements[i], rhs_elements[i])) {
+                return false;
+            }
+        }
+        return true;
+    } else if (Is<Symbol>(lhs) && Is<Symbol>(rhs)) {
+        return As<Symbol>(lhs)->GetName() == As<Symbol>(rhs)->GetName();
+    } else if (Is<Boolean>(lhs) && Is<Boolean>(rhs)) {
+        return As<Boolean>(lhs)->GetValue() == As<Boolean>(rhs)->GetValue();
+    }
+    return lhs == rhs;
+}
+
+bool IsComparedByValue(Object* obj_ptr) {
+    return Is<Number>(obj_ptr) || Is<BigNumber>(obj_ptr) || Is<Flonum>(obj_ptr) ||
+           Is<Symbol>(obj_ptr) || Is<Boolean>(obj_ptr);
+}
+
+bool EqvObjects(Object* lhs, Object* rhs) {
+    if (lhs == rhs) {
+        return true;
+    }
+    return IsComparedByValue(lhs) && IsComparedByValue(rhs) && EqualObjects(lhs, rhs);
+}
+
 void Cell::GatherSubobjects(std::set<Object*>& save) {
-	save.insert(this);
-	if (GetFirst()) {
-		GetFirst()->GatherSubobjects(save);
-	}
-	if (GetSecond()) {
-		GetSecond()->GatherSubobjects(save);
-	}
+    // the spine is walked iteratively, so that long lists do not overflow the stack, and visited
+    // cells are skipped, because lists may be cyclic after `set-cdr!`
+    Cell* cell_ptr = this;
+    while (save.insert(cell_ptr).second) {
+        if (Object* block = cell_ptr->GetBlock()) {
+            save.insert(block);
+        }
+        if (cell_ptr->GetFirst()) {
+            cell_ptr->GetFirst()->GatherSubobjects(save);
+        }
+        if (!Is<Cell>(cell_ptr->GetSecond())) {
+            if (cell_ptr->GetSecond()) {
+                cell_ptr->GetSecond()->GatherSubobjects(save);
+            }
+            break;
+        }
+        cell_ptr = As<Cell>(cell_ptr->GetSecond());
+    }
 }
 
 void ScopedFunction::GatherSubobjects(std::set<Object*>& save) {
-	save.insert(this);
-	for (auto [name, obj] : captured_variables_) {
-		save.insert(obj);
-	}
-	for (auto obj : commands_) {
-		save.insert(obj);
-	}
+    if (!save.insert(this).second) {
+        return;
+    }
+    // body and captured objects are traversed too, otherwise nested syntax tree nodes would be
+    // collected while the function is still alive
+    for (auto [name, obj] : captured_variables_) {
+        if (obj) {
+            obj->GatherSubobjects(save);
+        }
+    }
+    for (auto obj : commands_) {
+        if (obj) {
+            obj->GatherSubobjects(save);
+        }
+    }
 }
\ No newline at end of file
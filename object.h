@@ -1,6 +1,7 @@
 #pragma once
 
 #include "abstract_object.h"
+#include "big_integer.h"
 #include "scope.h"
 
 #include <string>
@@ -28,14 +29,62 @@ public:
         number_ = value;
     }
 
-    Object* Copy(std::shared_ptr<Scope> scope) const override {
-        return scope->CreateServiceObject<Number>(number_);
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<Number*>(this);  // numbers are immutable, sharing is safe
     }
 
 private:
     int64_t number_;
 };
 
+class BigNumber final : public Object {  // integer which does not fit into `Number`
+public:
+    BigNumber(BigInteger value) : number_(std::move(value)) {
+    }
+
+    const BigInteger& GetValue() const {
+        return number_;
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override {
+        return number_.ToString();
+    }
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<BigNumber*>(this);  // numbers are immutable, sharing is safe
+    }
+
+private:
+    BigInteger number_;
+};
+
+class Flonum final : public Object {  // inexact number, IEEE double
+public:
+    Flonum(double value) : number_(value) {
+    }
+
+    double GetValue() const {
+        return number_;
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override;
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<Flonum*>(this);  // numbers are immutable, sharing is safe
+    }
+
+private:
+    double number_;
+};
+
 class Symbol final : public Object {
 public:
     Symbol() = default;
@@ -88,11 +137,95 @@ public:
 
     void GatherSubobjects(std::set<Object*>& save) override;
 
+    virtual Object* GetBlock() const {  // registered owner of cells allocated in bulk
+        return nullptr;
+    }
+
 private:
     Object* first_obj_ = nullptr;
     Object* second_obj_ = nullptr;
 };
 
+class String final : public Object {  // immutable, short strings are stored inline by std::string
+public:
+    String() = default;
+    String(std::string value) : value_(std::move(value)) {
+    }
+
+    const std::string& GetValue() const {
+        return value_;
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override;
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<String*>(this);  // nothing can change the string, sharing is safe
+    }
+
+private:
+    std::string value_;
+};
+
+class StringBuilder final : public Object {  // mutable buffer for O(n) concatenation in loops
+public:
+    StringBuilder() = default;
+
+    std::string& GetBuffer() {
+        return buffer_;
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override {
+        return "#<string-builder>";
+    }
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        return const_cast<StringBuilder*>(this);  // shared by reference, like vectors
+    }
+
+private:
+    std::string buffer_;
+};
+
+class Vector final : public Object {  // contiguous array with O(1) indexing
+public:
+    Vector() = default;
+    Vector(std::vector<Object*> elements) : elements_(std::move(elements)) {
+    }
+
+    std::vector<Object*>& GetElements() {
+        return elements_;
+    }
+
+    const std::vector<Object*>& GetElements() const {
+        return elements_;
+    }
+
+    Object* Evaluate(std::shared_ptr<Scope>) override {
+        return this;
+    }
+
+    std::string Repr() const override;
+
+    Object* Copy(std::shared_ptr<Scope>) const override {
+        // vectors are mutable aggregates shared by reference, copying them on every call would
+        // make indexed access O(n) again
+        return const_cast<Vector*>(this);
+    }
+
+    void GatherSubobjects(std::set<Object*>& save) override;
+
+private:
+    std::vector<Object*> elements_;
+};
+
 class Function : public Object {
 public:
     Function(std::optional<size_t> args_count = std::nullopt) : args_count_(args_count) {
@@ -112,6 +245,12 @@ public:
         Cell* cell_ptr,
         std::shared_ptr<Scope> scope) = 0;  // this must be overriden by lambda or standart function
 
+    virtual Object* Apply(const std::vector<Object*>& arguments, std::shared_ptr<Scope> scope);
+    /*
+        Calls function with already evaluated arguments, used by builtins which receive
+       functions as parameters
+    */
+
     bool CorrectArgumentsQuantity(Cell* cell_ptr) const;
 
     virtual std::optional<size_t> ExpectedArgumentsCounter() const {
@@ -147,10 +286,33 @@ public:
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 
+    Object* Apply(const std::vector<Object*>& arguments, std::shared_ptr<Scope> scope) override;
+
     Object* Copy(std::shared_ptr<Scope> scope) const override;
 
     void GatherSubobjects(std::set<Object*>& save) override;
 
+    const std::vector<std::string>& GetArgumentNames() const {
+        return argnames_;
+    }
+
+    std::vector<Object*>& GetCommands() {
+        return commands_;
+    }
+
+    std::unordered_map<std::string, Object*>& GetCapturedVariables() {
+        return captured_variables_;
+    }
+
+    void Recapture(const std::string& name, Object* obj_ptr);
+    /*
+        Replaces captured value of the variable if the function captured it, used by `letrec` to
+        tie recursive definitions together
+    */
+
+private:
+    void NameCapturedVariables(std::shared_ptr<Scope> scope);
+
 private:
     std::vector<std::string> argnames_;
     std::vector<Object*>
@@ -177,6 +339,19 @@ public:
     }
 };
 
+class BinaryFunction : public StandartFunction {  // builtin with a fixed-arity fast path
+public:
+    BinaryFunction(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count) {
+    }
+
+    virtual Object* InvokeBinary(Object* lhs, Object* rhs, std::shared_ptr<Scope> scope) = 0;
+    /*
+        Called by `Cell::Evaluate` for `(f a b)` with already evaluated arguments, skipping
+       arguments quantity check, scope setup and variadic folding
+    */
+};
+
 class Boolean : public Object {
 public:
     Boolean(const std::string& name) : value_(name == "#t") {
@@ -185,6 +360,10 @@ public:
     Boolean(bool val) : value_(val) {
     }
 
+    bool GetValue() const {
+        return value_;
+    }
+
     std::string Repr() const override {
         return value_ ? "#t" : "#f";
     }
@@ -231,6 +410,20 @@ Object* CopyObject(Object* obj, std::shared_ptr<Scope> scope);
 
 bool IsBooleanConstant(Object* obj_ptr);
 
+Boolean* GetBooleanConstant(bool value);  // shared immutable `#t` and `#f`
+
+Number* CreateNumber(int64_t value, std::shared_ptr<Scope> scope);  // small numbers are shared
+
+Object* CreateInteger(BigInteger value, std::shared_ptr<Scope> scope);  // `Number` if fits
+
+size_t HashObject(Object* obj_ptr);  // structural hash, consistent with `EqualObjects`
+
+bool EqualObjects(Object* lhs, Object* rhs);  // structural equality of numbers, symbols and lists
+
+bool IsComparedByValue(Object* obj_ptr);  // numbers, symbols and booleans
+
+bool EqvObjects(Object* lhs, Object* rhs);  // by value if `IsComparedByValue`, else by identity
+
 template <class F>
 void ApplyToAllObjects(Object* obj_ptr, F&& function) {
     if (!obj_ptr) {
@@ -250,13 +443,13 @@ template <class F>
 void ApplyToList(const Cell* cell_ptr, F&& function) {
     while (cell_ptr) {
         function(cell_ptr->GetFirst());
-        if (Is<Cell>(cell_ptr->GetSecond())) {
-            cell_ptr = As<Cell>(cell_ptr->GetSecond());
-        } else {
+        const Cell* next_cell_ptr = As<Cell>(cell_ptr->GetSecond());
+        if (!next_cell_ptr) {
             if (cell_ptr->GetSecond()) {
                 function(cell_ptr->GetSecond());
             }
             break;
         }
+        cell_ptr = next_cell_ptr;
     }
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "parallel_reader.h"
+#include "garbage_collector.h"
+#include "parser.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace {
+
+constexpr size_t kMinPartSize = 1 << 20;  // smaller sources are not worth starting threads for
+
+std::vector<Object*> ReadSequentially(std::string_view source) {
+    Tokenizer tokenizer(source);
+    std::vector<Object*> objects;
+    while (!tokenizer.IsEnd()) {
+        objects.push_back(Read(&tokenizer));
+    }
+    return objects;
+}
+
+std::vector<size_t> FindSplitPoints(std::string_view source, size_t parts_count) {
+    // whitespace outside of lists and string literals separates top-level forms, unless it follows
+    // a quote, which belongs to the next datum
+    std::vector<size_t> splits;
+    size_t next_target = source.size() / parts_count;
+    int64_t depth = 0;
+    bool in_string = false;
+    bool escaped = false;
+    char last_significant = ' ';
+    for (size_t i = 0; i < source.size() && splits.size() + 1 < parts_count; ++i) {
+        char ch = source[i];
+        if (in_string) {
+            if (escaped) {
+                escaped = false;
+            } else if (ch == '\\') {
+                escaped = true;
+            } else if (ch == '"') {
+                in_string = false;
+            }
+            last_significant = ch;
+            continue;
+        }
+
+        if (StateMachine::IsWhitespace(ch)) {
+            if (depth == 0 && last_significant != '\'' && i >= next_target) {
+                splits.push_back(i);
+                next_target = source.size() / parts_count * (splits.size() + 1);
+            }
+            continue;
+        }
+
+        if (ch == '"') {
+            in_string = true;
+        } else if (ch == '(') {
+            ++depth;
+        } else if (ch == ')' && --depth < 0) {
+            break;  // sequential reading fails here, the part containing it reports the error
+        }
+        last_significant = ch;
+    }
+    return splits;
+}
+
+}  // namespace
+
+std::vector<Object*> ReadAll(std::string_view source, size_t threads_count) {
+    if (source.size() < 2 * kMinPartSize) {
+        return ReadSequentially(source);  // before asking for the number of cores, which is slow
+    }
+    if (threads_count == 0) {
+        threads_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    size_t parts_count = std::min(threads_count, source.size() / kMinPartSize);
+    if (parts_count < 2) {
+        return ReadSequentially(source);
+    }
+
+    std::vector<size_t> splits = FindSplitPoints(source, parts_count);
+    splits.insert(splits.begin(), 0);
+    splits.push_back(source.size());
+    parts_count = splits.size() - 1;
+
+    std::vector<std::vector<Object*>> results(parts_count);
+    std::vector<garbage_collector::GarbageCollector> heaps(parts_count);
+    std::vector<std::exception_ptr> errors(parts_count);
+    std::vector<std::thread> workers;
+    for (size_t part = 0; part < parts_count; ++part) {
+        workers.emplace_back([&, part] {
+            garbage_collector::HeapBinding binding(&heaps[part]);
+            try {
+                results[part] =
+                    ReadSequentially(source.substr(splits[part], splits[part + 1] - splits[part]));
+            } catch (...) {
+                errors[part] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<Object*> objects;
+    for (size_t part = 0; part < parts_count; ++part) {
+        garbage_collector::Instance().Merge(heaps[part]);
+    }
+    for (size_t part = 0; part < parts_count; ++part) {
+        if (errors[part]) {
+            std::rethrow_exception(errors[part]);  // the first error in the source order
+        }
+        objects.insert(objects.end(), results[part].begin(), results[part].end());
+    }
+    return objects;
+}
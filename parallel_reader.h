@@ -0,0 +1,15 @@
+#pragma once
+
+#include "object.h"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/*
+    Reads every form of the source, the result is the same as of sequential `Read` calls, including
+    the first error. Large sources are split at top-level form boundaries and the parts are read
+    by worker threads, each of them allocates into a heap of its own, which is merged into the
+    heap of the caller afterwards. Zero threads count means one per hardware thread
+*/
+std::vector<Object*> ReadAll(std::string_view source, size_t threads_count = 0);
@@ -12,20 +12,32 @@ Object* Read(Tokenizer* tokenizer) {
         return nullptr;
     }
 
-    auto token = tokenizer->GetToken();
-
-    // PrintToken(tokenizer->GetToken());
-
-    if (ConstantToken* constant = std::get_if<ConstantToken>(&token)) {
+    FormBuilder builder;
+    while (!tokenizer->IsEnd()) {
+        std::optional<Object*> obj_ptr = builder.Consume(tokenizer->GetToken());
         tokenizer->Next();
+        if (obj_ptr) {
+            return *obj_ptr;
+        }
+    }
+    throw SyntaxError("Expected ending of the list, no more tokens");
+}
+
+Object* CreateAtom(Token& token) {
+    // token is a reference, which is overwritten by `Next`, so objects are created before it
+    if (StringToken* string = std::get_if<StringToken>(&token)) {
+        // the literal is moved into the heap object without copying
+        return garbage_collector::Instance().RegisterObject<String>(std::move(string->value));
+    } else if (ConstantToken* constant = std::get_if<ConstantToken>(&token)) {
         return garbage_collector::Instance().RegisterObject<Number>(constant->value);
-    } else if (SymbolToken* symbol = std::get_if<SymbolToken>(&token)) {
-        tokenizer->Next();
-        return garbage_collector::Instance().RegisterObject<Symbol>(symbol->name);
-    } else if (std::get_if<QuoteToken>(&token)) {
-        return ReadQuoted(tokenizer);
+    } else if (FloatConstantToken* float_constant = std::get_if<FloatConstantToken>(&token)) {
+        return garbage_collector::Instance().RegisterObject<Flonum>(float_constant->value);
+    } else if (BigConstantToken* big_constant = std::get_if<BigConstantToken>(&token)) {
+        return garbage_collector::Instance().RegisterObject<BigNumber>(
+            BigInteger::FromString(big_constant->digits));
     } else {
-        return ReadList(tokenizer);
+        SymbolToken& symbol = std::get<SymbolToken>(token);
+        return garbage_collector::Instance().RegisterObject<Symbol>(std::string(symbol.name));
     }
 }
 
@@ -59,6 +71,12 @@ void PrintToken(Token token) {
         std::cerr << "`\'`";
     } else if (SymbolToken* symbol = std::get_if<SymbolToken>(&token)) {
         std::cerr << '`' << symbol->name << '`';
+    } else if (BigConstantToken* big_constant = std::get_if<BigConstantToken>(&token)) {
+        std::cerr << '`' << big_constant->digits << '`';
+    } else if (FloatConstantToken* float_constant = std::get_if<FloatConstantToken>(&token)) {
+        std::cerr << '`' << float_constant->value << '`';
+    } else if (StringToken* string = std::get_if<StringToken>(&token)) {
+        std::cerr << "`\"" << string->value << "\"`";
     } else {
         ConstantToken* constant = std::get_if<ConstantToken>(&token);
         std::cerr << "`" << constant->value << "`";
@@ -66,86 +84,87 @@ void PrintToken(Token token) {
     std::cerr << "\n";
 }
 
-Object* ReadQuoted(Tokenizer* tokenizer) {
-    Cell* first_cell_ptr = garbage_collector::Instance().RegisterObject<Cell>();
-    first_cell_ptr->GetFirst() = garbage_collector::Instance().RegisterObject<Symbol>("quote");
-    tokenizer->Next();
-    auto obj_ptr = Read(tokenizer);
-    auto new_cell_ptr = garbage_collector::Instance().RegisterObject<Cell>();
-    first_cell_ptr->GetSecond() = new_cell_ptr;
-    new_cell_ptr->GetFirst() = obj_ptr;
-    return first_cell_ptr;
-}
-
-Object* ReadList(Tokenizer* tokenizer) {
-    if (!IsOpeningParToken(tokenizer->GetToken())) {
-        throw SyntaxError("Expected opening bracket");
+std::optional<Object*> FormBuilder::Consume(Token& token) {
+    if (!stack_.empty() && !stack_.back().is_quote && stack_.back().set_after_dot &&
+        !IsClosingParToken(token)) {
+        throw SyntaxError("Expected closing bracket");
     }
 
-    bool found_dot = false;
-    bool set_after_dot = false;
-    Cell* current_cell_ptr = nullptr;
-    Cell* first_cell_ptr = nullptr;
-
-    auto current_cell = [&]() -> Cell*& {
-        if (current_cell_ptr) {
-            return current_cell_ptr;
-        } else {
-            return current_cell_ptr = first_cell_ptr =
-                       garbage_collector::Instance().RegisterObject<Cell>();
+    if (IsOpeningParToken(token)) {
+        stack_.push_back(Frame{});
+        return std::nullopt;
+    } else if (IsQuoteToken(token)) {
+        stack_.push_back(Frame{.is_quote = true});
+        return std::nullopt;
+    } else if (IsClosingParToken(token) || IsDotToken(token)) {
+        if (stack_.empty() || stack_.back().is_quote) {
+            throw SyntaxError("Expected opening bracket");
         }
-    };
-
-    auto add_element_in_list = [&](Object* obj_ptr) {
-        if (first_cell_ptr) {
-            if (found_dot) {
-                current_cell()->GetSecond() = obj_ptr;
-                set_after_dot = true;
-            } else {
-                Cell* new_cell_ptr = garbage_collector::Instance().RegisterObject<Cell>();
-                current_cell()->GetSecond() = new_cell_ptr;
-                current_cell() = new_cell_ptr;
-                current_cell()->GetFirst() = obj_ptr;
-            }
-        } else {
-            if (found_dot) {
-                throw SyntaxError("Dot cannot be first in list");
+        Frame& frame = stack_.back();
+        if (IsDotToken(token)) {
+            if (frame.found_dot) {
+                throw SyntaxError("Too much dots in list");
             }
-            current_cell()->GetFirst() = obj_ptr;
+            frame.found_dot = true;
+            return std::nullopt;
         }
-    };
-
-    // PrintToken(tokenizer->GetToken());
-
-    tokenizer->Next();
-    while (true) {
-        if (tokenizer->IsEnd()) {
-            throw SyntaxError("Expected ending of the list, no more tokens");
+        if (frame.found_dot && !frame.set_after_dot) {
+            throw SyntaxError("No arguments after `.` in list");
         }
+        Object* list_ptr = frame.first_cell_ptr;
+        stack_.pop_back();
+        return Complete(list_ptr);
+    }
+    return Complete(CreateAtom(token));
+}
 
-        auto token = tokenizer->GetToken();
+bool FormBuilder::IsInsideForm() const {
+    return !stack_.empty();
+}
 
-        // PrintToken(token);
+void FormBuilder::Reset() {
+    stack_.clear();
+}
 
-        if (set_after_dot && !IsClosingParToken(token)) {
-            throw SyntaxError("Expected closing bracket");
+void FormBuilder::GatherSubobjects(std::set<Object*>& save) const {
+    for (const Frame& frame : stack_) {
+        if (frame.first_cell_ptr) {
+            frame.first_cell_ptr->GatherSubobjects(save);
         }
+    }
+}
 
-        if (IsDotToken(token)) {
-            if (found_dot) {
-                throw SyntaxError("Too much dots in list");
-            }
-            found_dot = true;
-            tokenizer->Next();
-        } else if (IsClosingParToken(token)) {
-            if (found_dot && !set_after_dot) {
-                throw SyntaxError("No arguments after `.` in list");
-            }
-            tokenizer->Next();
-            return first_cell_ptr;
-        } else {
-            auto obj_ptr = Read(tokenizer);
-            add_element_in_list(obj_ptr);
+std::optional<Object*> FormBuilder::Complete(Object* obj_ptr) {
+    while (!stack_.empty() && stack_.back().is_quote) {
+        // `'x` is read as `(quote x)`
+        Cell* first_cell_ptr = garbage_collector::Instance().RegisterObject<Cell>();
+        first_cell_ptr->GetFirst() = garbage_collector::Instance().RegisterObject<Symbol>("quote");
+        Cell* new_cell_ptr = garbage_collector::Instance().RegisterObject<Cell>();
+        first_cell_ptr->GetSecond() = new_cell_ptr;
+        new_cell_ptr->GetFirst() = obj_ptr;
+        obj_ptr = first_cell_ptr;
+        stack_.pop_back();
+    }
+    if (stack_.empty()) {
+        return obj_ptr;
+    }
+
+    Frame& frame = stack_.back();
+    if (!frame.first_cell_ptr) {
+        if (frame.found_dot) {
+            throw SyntaxError("Dot cannot be first in list");
         }
+        frame.first_cell_ptr = frame.last_cell_ptr =
+            garbage_collector::Instance().RegisterObject<Cell>();
+        frame.last_cell_ptr->GetFirst() = obj_ptr;
+    } else if (frame.found_dot) {
+        frame.last_cell_ptr->GetSecond() = obj_ptr;
+        frame.set_after_dot = true;
+    } else {
+        Cell* new_cell_ptr = garbage_collector::Instance().RegisterObject<Cell>();
+        frame.last_cell_ptr->GetSecond() = new_cell_ptr;
+        frame.last_cell_ptr = new_cell_ptr;
+        new_cell_ptr->GetFirst() = obj_ptr;
     }
-}
\ No newline at end of file
+    return std::nullopt;
+}
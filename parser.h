@@ -3,10 +3,36 @@
 #include "object.h"
 #include "tokenizer.h"
 
-Object* Read(Tokenizer* tokenizer);
+#include <optional>
+#include <set>
+#include <vector>
 
-Object* ReadQuoted(Tokenizer* tokenizer);
+Object* Read(Tokenizer* tokenizer);  // one form, nullptr if there are no more tokens
 
-Object* ReadList(Tokenizer* tokenizer);
+Object* CreateAtom(Token& token);  // registers the object, the token may be moved from
+
+class FormBuilder {  // assembles forms token by token, unfinished lists are kept between calls
+public:
+    std::optional<Object*> Consume(Token& token);  // the top-level form, once it is completed
+
+    bool IsInsideForm() const;
+
+    void Reset();  // drops the unfinished form
+
+    void GatherSubobjects(std::set<Object*>& save) const;  // unfinished lists, for collections
+
+private:
+    struct Frame {
+        Cell* first_cell_ptr = nullptr;
+        Cell* last_cell_ptr = nullptr;
+        bool is_quote = false;  // waits for one datum, which becomes `(quote datum)`
+        bool found_dot = false;
+        bool set_after_dot = false;
+    };
+
+    std::optional<Object*> Complete(Object* obj_ptr);  // attaches a datum to the innermost list
+
+    std::vector<Frame> stack_;
+};
 
 void PrintToken(Token token);
\ No newline at end of file
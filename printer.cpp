@@ -0,0 +1,169 @@
+#include "printer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+class PrintSink {
+public:
+    virtual void Write(std::string_view text) = 0;
+
+    virtual bool IsFull() const {  // nothing more can be written, printing stops early
+        return false;
+    }
+
+    virtual ~PrintSink() = default;
+};
+
+class StreamSink final : public PrintSink {
+public:
+    StreamSink(std::ostream* out) : out_(out) {
+    }
+
+    void Write(std::string_view text) override {
+        out_->write(text.data(), text.size());
+    }
+
+private:
+    std::ostream* out_;
+};
+
+class StringSink final : public PrintSink {
+public:
+    void Write(std::string_view text) override {
+        result_ += text;
+    }
+
+    std::string& GetResult() {
+        return result_;
+    }
+
+private:
+    std::string result_;
+};
+
+class BufferSink final : public PrintSink {
+public:
+    BufferSink(std::span<char> buffer) : buffer_(buffer) {
+    }
+
+    void Write(std::string_view text) override {
+        size_t count = std::min(text.size(), buffer_.size() - size_);
+        std::memcpy(buffer_.data() + size_, text.data(), count);
+        size_ += count;
+        truncated_ |= count < text.size();
+    }
+
+    bool IsFull() const override {
+        return truncated_;
+    }
+
+    size_t Finish() {
+        if (truncated_) {
+            std::string_view mark = "...";
+            size_t count = std::min(mark.size(), buffer_.size());
+            std::memcpy(buffer_.data() + buffer_.size() - count, mark.data(), count);
+        }
+        return size_;
+    }
+
+private:
+    std::span<char> buffer_;
+    size_t size_ = 0;
+    bool truncated_ = false;
+};
+
+class Printer {
+public:
+    Printer(PrintSink* sink, const PrintLimits& limits) : sink_(sink), limits_(limits) {
+    }
+
+    void Print(Object* obj_ptr) {
+        PrintValue(obj_ptr);
+        while (!stack_.empty() && !sink_->IsFull()) {
+            // the reference is not used after `PrintValue`, which may push another frame
+            Frame& frame = stack_.back();
+            if (frame.vector ? frame.index == frame.vector->GetElements().size() : !frame.rest) {
+                sink_->Write(")");
+                stack_.pop_back();
+                continue;
+            }
+            if (frame.vector || Is<Cell>(frame.rest)) {
+                if (frame.index) {
+                    sink_->Write(" ");
+                }
+                if (limits_.max_length && frame.index == *limits_.max_length) {
+                    sink_->Write("...)");
+                    stack_.pop_back();
+                    continue;
+                }
+            }
+
+            Object* element = nullptr;
+            if (frame.vector) {
+                element = frame.vector->GetElements()[frame.index++];
+            } else if (Cell* cell_ptr = As<Cell>(frame.rest)) {
+                element = cell_ptr->GetFirst();
+                frame.rest = cell_ptr->GetSecond();
+                ++frame.index;
+            } else {
+                sink_->Write(" . ");
+                element = frame.rest;
+                frame.rest = nullptr;
+            }
+            PrintValue(element);
+        }
+    }
+
+private:
+    struct Frame {
+        const Vector* vector = nullptr;  // or a list, if not set
+        Object* rest = nullptr;          // unprinted part of the list, which may be a dotted tail
+        size_t index = 0;                // printed elements
+    };
+
+    void PrintValue(Object* obj_ptr) {
+        bool is_vector = Is<Vector>(obj_ptr);
+        if (!is_vector && !Is<Cell>(obj_ptr)) {
+            sink_->Write(GetRepr(obj_ptr));
+            return;
+        }
+        if (limits_.max_depth && stack_.size() >= *limits_.max_depth) {
+            sink_->Write("...");
+            return;
+        }
+        if (is_vector) {
+            sink_->Write("#(");
+            stack_.push_back(Frame{.vector = As<Vector>(obj_ptr)});
+        } else {
+            sink_->Write("(");
+            stack_.push_back(Frame{.rest = obj_ptr});
+        }
+    }
+
+    PrintSink* sink_;
+    const PrintLimits& limits_;
+    std::vector<Frame> stack_;
+};
+
+}  // namespace
+
+void PrintObject(Object* obj_ptr, std::ostream* out, const PrintLimits& limits) {
+    StreamSink sink(out);
+    Printer(&sink, limits).Print(obj_ptr);
+}
+
+size_t PrintObject(Object* obj_ptr, std::span<char> buffer, const PrintLimits& limits) {
+    BufferSink sink(buffer);
+    Printer(&sink, limits).Print(obj_ptr);
+    return sink.Finish();
+}
+
+std::string PrintToString(Object* obj_ptr, const PrintLimits& limits) {
+    StringSink sink;
+    Printer(&sink, limits).Print(obj_ptr);
+    return std::move(sink.GetResult());
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "object.h"
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+
+struct PrintLimits {
+    std::optional<size_t> max_depth;   // lists and vectors nested deeper are printed as `...`
+    std::optional<size_t> max_length;  // elements of a list or vector after this many are `...`
+};
+
+/*
+    Writes the same text as `GetRepr` in one pass, without building strings for nested lists.
+    Lists and vectors are walked with an explicit stack, so deep nesting does not recurse, and
+    cyclic lists terminate once `max_length` is set
+*/
+void PrintObject(Object* obj_ptr, std::ostream* out, const PrintLimits& limits = {});
+
+size_t PrintObject(Object* obj_ptr, std::span<char> buffer, const PrintLimits& limits = {});
+/*
+    Returns the number of written characters, the text which does not fit is cut and ends with
+    `...` instead
+*/
+
+std::string PrintToString(Object* obj_ptr, const PrintLimits& limits = {});
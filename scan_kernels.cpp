@@ -0,0 +1,166 @@
+#include "scan_kernels.h"
+#include "vector_kernels.h"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_AVX2_KERNELS
+#endif
+
+namespace {
+
+namespace scalar {
+
+bool Matches(unsigned char ch, CharRun run) {
+    switch (run) {
+        case CharRun::Whitespace:
+            return ch == ' ' || (ch >= '\t' && ch <= '\r');
+        case CharRun::Digits:
+            return ch >= '0' && ch <= '9';
+        case CharRun::SymbolChars:
+            return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') ||
+                   (ch >= 'A' && ch <= 'Z') || (ch >= '<' && ch <= '?') || ch == '!' ||
+                   ch == '#' || ch == '*' || ch == '-' || ch == '/';
+        case CharRun::StringChars:
+            return ch != '"' && ch != '\\';
+    }
+    return false;
+}
+
+size_t SkipRun(const char* data, size_t size, CharRun run) {
+    size_t i = 0;
+    while (i < size && Matches(data[i], run)) {
+        ++i;
+    }
+    return i;
+}
+
+}  // namespace scalar
+
+#ifdef __SSE2__
+
+namespace sse2 {  // sixteen bytes at once
+
+/*
+    Bytes are compared as signed, so everything above 127 is negative and falls out of every
+    printable range
+*/
+__m128i InRange(__m128i bytes, char low, char high) {
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(low - 1)),
+                         _mm_cmplt_epi8(bytes, _mm_set1_epi8(high + 1)));
+}
+
+__m128i Equals(__m128i bytes, char ch) {
+    return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(ch));
+}
+
+__m128i Matches(__m128i bytes, CharRun run) {
+    switch (run) {
+        case CharRun::Whitespace:
+            return _mm_or_si128(Equals(bytes, ' '), InRange(bytes, '\t', '\r'));
+        case CharRun::Digits:
+            return InRange(bytes, '0', '9');
+        case CharRun::SymbolChars: {
+            __m128i letters = _mm_or_si128(InRange(bytes, 'a', 'z'), InRange(bytes, 'A', 'Z'));
+            __m128i signs = _mm_or_si128(
+                _mm_or_si128(Equals(bytes, '!'), Equals(bytes, '#')),
+                _mm_or_si128(_mm_or_si128(Equals(bytes, '*'), Equals(bytes, '-')),
+                             Equals(bytes, '/')));
+            return _mm_or_si128(_mm_or_si128(letters, signs),
+                                _mm_or_si128(InRange(bytes, '0', '9'), InRange(bytes, '<', '?')));
+        }
+        case CharRun::StringChars:
+            return _mm_andnot_si128(_mm_or_si128(Equals(bytes, '"'), Equals(bytes, '\\')),
+                                    _mm_set1_epi8(-1));
+    }
+    return _mm_setzero_si128();
+}
+
+size_t SkipRun(const char* data, size_t size, CharRun run) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mismatches = ~_mm_movemask_epi8(Matches(bytes, run)) & 0xFFFF;
+        if (mismatches) {
+            return i + std::countr_zero(mismatches);
+        }
+    }
+    return i + scalar::SkipRun(data + i, size - i, run);
+}
+
+}  // namespace sse2
+
+#else
+
+namespace sse2 = scalar;
+
+#endif
+
+#ifdef HAS_AVX2_KERNELS
+
+namespace avx2 {  // thirty two bytes at once, compiled for AVX2 and called only on it
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET __m256i InRange(__m256i bytes, char low, char high) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(low - 1)),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), bytes));
+}
+
+AVX2_TARGET __m256i Equals(__m256i bytes, char ch) {
+    return _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(ch));
+}
+
+AVX2_TARGET __m256i Matches(__m256i bytes, CharRun run) {
+    switch (run) {
+        case CharRun::Whitespace:
+            return _mm256_or_si256(Equals(bytes, ' '), InRange(bytes, '\t', '\r'));
+        case CharRun::Digits:
+            return InRange(bytes, '0', '9');
+        case CharRun::SymbolChars: {
+            __m256i letters =
+                _mm256_or_si256(InRange(bytes, 'a', 'z'), InRange(bytes, 'A', 'Z'));
+            __m256i signs = _mm256_or_si256(
+                _mm256_or_si256(Equals(bytes, '!'), Equals(bytes, '#')),
+                _mm256_or_si256(_mm256_or_si256(Equals(bytes, '*'), Equals(bytes, '-')),
+                                Equals(bytes, '/')));
+            return _mm256_or_si256(
+                _mm256_or_si256(letters, signs),
+                _mm256_or_si256(InRange(bytes, '0', '9'), InRange(bytes, '<', '?')));
+        }
+        case CharRun::StringChars:
+            return _mm256_andnot_si256(
+                _mm256_or_si256(Equals(bytes, '"'), Equals(bytes, '\\')), _mm256_set1_epi8(-1));
+    }
+    return _mm256_setzero_si256();
+}
+
+AVX2_TARGET size_t SkipRun(const char* data, size_t size, CharRun run) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mismatches = ~static_cast<uint32_t>(_mm256_movemask_epi8(Matches(bytes, run)));
+        if (mismatches) {
+            return i + std::countr_zero(mismatches);
+        }
+    }
+    return i + sse2::SkipRun(data + i, size - i, run);
+}
+
+#undef AVX2_TARGET
+
+}  // namespace avx2
+
+#else
+
+namespace avx2 = sse2;
+
+#endif
+
+}  // namespace
+
+size_t SkipRun(const char* data, size_t size, CharRun run) {
+    return HasAvx2() ? avx2::SkipRun(data, size, run) : sse2::SkipRun(data, size, run);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+    Byte scanning kernels of the tokenizer. Like the numeric kernels they run AVX2 or SSE2 code
+    depending on the CPU and fall back to a scalar loop elsewhere
+*/
+
+enum class CharRun {
+    Whitespace,   // ` `, `\t`, `\n`, `\v`, `\f` and `\r`
+    Digits,       // `0` to `9`
+    SymbolChars,  // letters, digits and `*#<>=?!-/`, which may continue a symbol
+    StringChars   // everything but `"` and `\`, which continue a string literal body
+};
+
+size_t SkipRun(const char* data, size_t size, CharRun run);  // length of the leading run
@@ -1,82 +1,366 @@
 #include "scheme.h"
 
-#include <sstream>
+#include "compiled_forms.h"
 #include "garbage_collector.h"
+#include "heap_image.h"
+#include "image_io.h"
+#include "mapped_file.h"
+#include "parallel_reader.h"
 #include "object.h"
 #include "standart_functions.h"
 
-Interpreter::Interpreter() : global_scope_(std::make_shared<Scope>()) {
+Builtins::Builtins() {
+    garbage_collector::HeapBinding binding(&heap_);
+    Scope global_scope;
+
     // quote
-    global_scope_->CreateObject<Quote>("quote", 1);
+    global_scope.CreateObject<Quote>("quote", 1);
 
     // booleans
-    global_scope_->CreateObject<IsBoolean>("boolean?", 1);
-    global_scope_->CreateObject<NotFunction>("not", 1);
-    global_scope_->CreateObject<AndFunction>("and", std::nullopt);
-    global_scope_->CreateObject<OrFunction>("or", std::nullopt);
+    global_scope.CreateObject<IsBoolean>("boolean?", 1);
+    global_scope.CreateObject<NotFunction>("not", 1);
+    global_scope.CreateObject<AndFunction>("and", std::nullopt);
+    global_scope.CreateObject<OrFunction>("or", std::nullopt);
 
     // integers
-    global_scope_->CreateObject<IsNumber>("number?", 1);
-    global_scope_->CreateObject<Equal>("=", std::nullopt);
-    global_scope_->CreateObject<Less>("<", std::nullopt);
-    global_scope_->CreateObject<Greater>(">", std::nullopt);
-    global_scope_->CreateObject<LessEqual>("<=", std::nullopt);
-    global_scope_->CreateObject<GreaterEqual>(">=", std::nullopt);
-    global_scope_->CreateObject<Addition>("+", std::nullopt);
-    global_scope_->CreateObject<Subtraction>("-", std::nullopt);
-    global_scope_->CreateObject<Multiplication>("*", std::nullopt);
-    global_scope_->CreateObject<Division>("/", std::nullopt);
-    global_scope_->CreateObject<Minimum>("min", std::nullopt);
-    global_scope_->CreateObject<Maximum>("max", std::nullopt);
-    global_scope_->CreateObject<AbsoluteValue>("abs", 1);
+    global_scope.CreateObject<IsNumber>("number?", 1);
+    global_scope.CreateObject<Equal>("=", std::nullopt);
+    global_scope.CreateObject<Less>("<", std::nullopt);
+    global_scope.CreateObject<Greater>(">", std::nullopt);
+    global_scope.CreateObject<LessEqual>("<=", std::nullopt);
+    global_scope.CreateObject<GreaterEqual>(">=", std::nullopt);
+    global_scope.CreateObject<Addition>("+", std::nullopt);
+    global_scope.CreateObject<Subtraction>("-", std::nullopt);
+    global_scope.CreateObject<Multiplication>("*", std::nullopt);
+    global_scope.CreateObject<Division>("/", std::nullopt);
+    global_scope.CreateObject<Minimum>("min", std::nullopt);
+    global_scope.CreateObject<Maximum>("max", std::nullopt);
+    global_scope.CreateObject<VectorSum>("vector-sum", 1);
+    global_scope.CreateObject<VectorDot>("vector-dot", 2);
+    global_scope.CreateObject<VectorMin>("vector-min", 1);
+    global_scope.CreateObject<VectorMax>("vector-max", 1);
+    global_scope.CreateObject<VectorAdd>("vector-add!", 2);
+    global_scope.CreateObject<VectorScale>("vector-scale!", 2);
+    global_scope.CreateObject<VectorCountIf>("vector-count-if", 3);
+    global_scope.CreateObject<AbsoluteValue>("abs", 1);
+    global_scope.CreateObject<ExactToInexact>("exact->inexact", 1);
+    global_scope.CreateObject<InexactToExact>("inexact->exact", 1);
 
     // lists and pairs
-    global_scope_->CreateObject<IsPair>("pair?", 1);
-    global_scope_->CreateObject<IsNull>("null?", 1);
-    global_scope_->CreateObject<IsList>("list?", 1);
-    global_scope_->CreateObject<ConsOperation>("cons", 2);
-    global_scope_->CreateObject<CarOperation>("car", 1);
-    global_scope_->CreateObject<CdrOperation>("cdr", 1);
-    global_scope_->CreateObject<ListMaker>("list", std::nullopt);
-    global_scope_->CreateObject<ListRef>("list-ref", 2);
-    global_scope_->CreateObject<ListTail>("list-tail", 2);
+    global_scope.CreateObject<IsPair>("pair?", 1);
+    global_scope.CreateObject<IsNull>("null?", 1);
+    global_scope.CreateObject<IsList>("list?", 1);
+    global_scope.CreateObject<ConsOperation>("cons", 2);
+    global_scope.CreateObject<CarOperation>("car", 1);
+    global_scope.CreateObject<CdrOperation>("cdr", 1);
+    global_scope.CreateObject<ListMaker>("list", std::nullopt);
+    global_scope.CreateObject<ListRef>("list-ref", 2);
+    global_scope.CreateObject<ListTail>("list-tail", 2);
+    global_scope.CreateObject<LengthOperation>("length", 1);
+    global_scope.CreateObject<AppendOperation>("append", std::nullopt);
+    global_scope.CreateObject<ReverseOperation>("reverse", 1);
+    global_scope.CreateObject<MapOperation>("map", std::nullopt);
+    global_scope.CreateObject<FilterOperation>("filter", 2);
+    global_scope.CreateObject<FoldLeftOperation>("fold-left", std::nullopt);
+    global_scope.CreateObject<FoldRightOperation>("fold-right", std::nullopt);
+    global_scope.CreateObject<ForEachOperation>("for-each", std::nullopt);
+    global_scope.CreateObject<MemberOperation>("member", 2);
+    global_scope.CreateObject<MemqOperation>("memq", 2);
+    global_scope.CreateObject<AssocOperation>("assoc", 2);
+    global_scope.CreateObject<AssqOperation>("assq", 2);
+
+    // vectors
+    global_scope.CreateObject<IsVector>("vector?", 1);
+    global_scope.CreateObject<MakeVector>("make-vector", std::nullopt);
+    global_scope.CreateObject<VectorMaker>("vector", std::nullopt);
+    global_scope.CreateObject<VectorRef>("vector-ref", 2);
+    global_scope.CreateObject<VectorSet>("vector-set!", 3);
+    global_scope.CreateObject<VectorLength>("vector-length", 1);
+    global_scope.CreateObject<VectorToList>("vector->list", 1);
+    global_scope.CreateObject<ListToVectorOperation>("list->vector", 1);
+
+    // bytevectors
+    global_scope.CreateObject<IsBytevector>("bytevector?", 1);
+    global_scope.CreateObject<MakeBytevector>("make-bytevector", std::nullopt);
+    global_scope.CreateObject<BytevectorU8Ref>("bytevector-u8-ref", 2);
+    global_scope.CreateObject<BytevectorU8Set>("bytevector-u8-set!", 3);
+    global_scope.CreateObject<BytevectorS64Ref>("bytevector-s64-ref", 2);
+    global_scope.CreateObject<BytevectorLength>("bytevector-length", 1);
+    global_scope.CreateObject<MmapFile>("mmap-file", 1);
+    global_scope.CreateObject<CompileFileFunction>("compile-file", 2);
+    global_scope.CreateObject<ReadFunction>("read", 1);
+
+    // strings
+    global_scope.CreateObject<IsString>("string?", 1);
+    global_scope.CreateObject<StringLength>("string-length", 1);
+    global_scope.CreateObject<StringRef>("string-ref", 2);
+    global_scope.CreateObject<Substring>("substring", std::nullopt);
+    global_scope.CreateObject<StringAppend>("string-append", std::nullopt);
+    global_scope.CreateObject<StringEqual>("string=?", std::nullopt);
+    global_scope.CreateObject<MakeStringBuilder>("make-string-builder", 0);
+    global_scope.CreateObject<StringBuilderAppend>("string-builder-append!", std::nullopt);
+    global_scope.CreateObject<StringBuilderToString>("string-builder->string", 1);
+
+    // hash tables
+    global_scope.CreateObject<IsHashTable>("hash-table?", 1);
+    global_scope.CreateObject<MakeHashTable>("make-hash-table", std::nullopt);
+    global_scope.CreateObject<HashTableRef>("hash-table-ref", std::nullopt);
+    global_scope.CreateObject<HashTableSet>("hash-table-set!", 3);
+    global_scope.CreateObject<HashTableDelete>("hash-table-delete!", 2);
+    global_scope.CreateObject<HashTableCount>("hash-table-count", 1);
+    global_scope.CreateObject<HashTableContains>("hash-table-contains?", 2);
+    global_scope.CreateObject<HashTableKeys>("hash-table-keys", 1);
+    global_scope.CreateObject<HashTableValues>("hash-table-values", 1);
+    global_scope.CreateObject<HashTableToAlist>("hash-table->alist", 1);
+    global_scope.CreateObject<HashTableWalk>("hash-table-walk", 2);
 
     // if
-    global_scope_->CreateObject<IfStatement>("if", std::nullopt);
+    global_scope.CreateObject<IfStatement>("if", std::nullopt);
+
+    // binding and control forms
+    global_scope.CreateObject<BeginStatement>("begin", std::nullopt);
+    global_scope.CreateObject<LetStatement>("let", std::nullopt);
+    global_scope.CreateObject<LetStarStatement>("let*", std::nullopt);
+    global_scope.CreateObject<LetrecStatement>("letrec", std::nullopt);
+    global_scope.CreateObject<CondStatement>("cond", std::nullopt);
+    global_scope.CreateObject<CaseStatement>("case", std::nullopt);
+    global_scope.CreateObject<WhenStatement>("when", std::nullopt);
+    global_scope.CreateObject<UnlessStatement>("unless", std::nullopt);
+    global_scope.CreateObject<DoStatement>("do", std::nullopt);
 
     // define
-    global_scope_->CreateObject<Definition>("define", std::nullopt);
+    global_scope.CreateObject<Definition>("define", std::nullopt);
+
+    // memoization
+    global_scope.CreateObject<DefineMemoized>("define-memoized", std::nullopt);
+    global_scope.CreateObject<Memoize>("memoize", std::nullopt);
+    global_scope.CreateObject<MemoizeHits>("memoize-hits", 1);
+    global_scope.CreateObject<MemoizeMisses>("memoize-misses", 1);
+
+    // parallelism
+    global_scope.CreateObject<FutureFunction>("future", 1);
+    global_scope.CreateObject<TouchFunction>("touch", 1);
+    global_scope.CreateObject<ParallelMap>("pmap", std::nullopt);
 
     // setters
-    global_scope_->CreateObject<SetVariable>("set!", std::nullopt);
-    global_scope_->CreateObject<SetCar>("set-car!", std::nullopt);
-    global_scope_->CreateObject<SetCdr>("set-cdr!", std::nullopt);
+    global_scope.CreateObject<SetVariable>("set!", std::nullopt);
+    global_scope.CreateObject<SetCar>("set-car!", std::nullopt);
+    global_scope.CreateObject<SetCdr>("set-cdr!", std::nullopt);
 
     // symbols
-    global_scope_->CreateObject<IsSymbol>("symbol?", 1);
+    global_scope.CreateObject<IsSymbol>("symbol?", 1);
 
     // lambda
-    global_scope_->CreateObject<MakeLambda>("lambda", std::nullopt);
+    global_scope.CreateObject<MakeLambda>("lambda", std::nullopt);
+
+    functions_ = global_scope.GetObjectsInThisScope();
+}
+
+Interpreter::Interpreter() : Interpreter(std::make_shared<Builtins>()) {
+}
+
+Interpreter::Interpreter(std::shared_ptr<const Builtins> builtins)
+    : shared_builtins_(std::move(builtins)),
+      global_scope_(std::make_shared<Scope>()),
+      builtins_(shared_builtins_->GetFunctions()) {
+    for (const auto& [name, obj_ptr] : builtins_) {
+        global_scope_->NameObject(obj_ptr, name);
+    }
 }
 
 std::string Interpreter::Run(const std::string& command) {
-	garbage_collector::Instance().CollectExcept(global_scope_->GatherReferredObjects());
+    garbage_collector::HeapBinding binding(&heap_);
+    std::optional<Object*> result = EvaluateForms(ReadAll(command));
+    return result ? GetRepr(*result) : "";
+}
 
-    std::stringstream s(command);
-    Tokenizer tokenizer(&s);
-    std::vector<Object*> objects;
-    while (!tokenizer.IsEnd()) {
-        objects.push_back(Read(&tokenizer));
+void Interpreter::Run(const std::string& command, std::ostream* out, const PrintLimits& limits) {
+    garbage_collector::HeapBinding binding(&heap_);
+    if (std::optional<Object*> result = EvaluateForms(ReadAll(command))) {
+        PrintObject(*result, out, limits);
     }
+}
+
+std::vector<BatchResult> Interpreter::RunBatch(std::span<const std::string> inputs) {
+    garbage_collector::HeapBinding binding(&heap_);
+    std::vector<BatchResult> results(inputs.size());
+    Tokenizer tokenizer;
+    std::vector<Object*> forms;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        try {
+            tokenizer.Reset(inputs[i]);
+            forms.clear();
+            while (!tokenizer.IsEnd()) {
+                forms.push_back(Read(&tokenizer));
+            }
+            if (std::optional<Object*> value = EvaluateForms(forms)) {
+                results[i].value = GetRepr(*value);
+            }
+        } catch (...) {
+            results[i].error = std::current_exception();
+        }
+    }
+    return results;
+}
+
+std::string Interpreter::RunFile(const std::string& path) {
+    garbage_collector::HeapBinding binding(&heap_);
+    MappedFile source(path);
+    Tokenizer tokenizer(source.GetView());
+    FormBuilder builder;
+    std::optional<std::string> result;
+    RunForms(&tokenizer, &builder, &result);
+    if (builder.IsInsideForm()) {
+        throw SyntaxError("Expected ending of the list, no more tokens");
+    }
+    return result.value_or("");
+}
 
-    std::string result;
-    for (Object* obj_ptr : objects) {
-    	std::set<Object*> important = global_scope_->GatherReferredObjects();
-    	important.insert(obj_ptr);
-    	garbage_collector::Instance().CollectExcept(important);
+std::string Interpreter::RunCompiled(const std::string& path) {
+    garbage_collector::HeapBinding binding(&heap_);
+    MappedFile image(path);
+    std::optional<Object*> result = EvaluateForms(LoadForms(image.GetView()));
+    return result ? GetRepr(*result) : "";
+}
+
+std::string Interpreter::RunStream(std::istream* in) {
+    garbage_collector::HeapBinding binding(&heap_);
+    Tokenizer tokenizer;
+    FormBuilder builder;
+    std::optional<std::string> result;
+    auto run_forms = [&] { RunForms(&tokenizer, &builder, &result); };
 
-        result = GetRepr(EvaluateObject(obj_ptr, global_scope_));
+    char chunk[1 << 16];
+    while (in->read(chunk, sizeof(chunk)) || in->gcount() > 0) {
+        tokenizer.Feed(std::string_view(chunk, in->gcount()));
+        run_forms();
     }
+    tokenizer.FinishFeed();
+    run_forms();
+    if (builder.IsInsideForm()) {
+        throw SyntaxError("Expected ending of the list, no more tokens");
+    }
+    return result.value_or("");
+}
 
+void Interpreter::SaveImage(const std::string& path) {
+    garbage_collector::HeapBinding binding(&heap_);
+    WriteImageFile(path, WriteHeapImage(global_scope_->GetObjectsInThisScope(), builtins_));
+}
+
+void Interpreter::LoadImage(const std::string& path) {
+    garbage_collector::HeapBinding binding(&heap_);
+    MappedFile image(path);
+    Bindings bindings = ReadHeapImage(image.GetView(), builtins_);
+    // functions keep their captures by value, so nothing refers to the old scope
+    global_scope_ = std::make_shared<Scope>();
+    for (const auto& [name, obj_ptr] : bindings) {
+        global_scope_->NameObject(obj_ptr, name);
+    }
+}
+
+std::optional<std::string> Interpreter::Feed(std::string_view chunk) {
+    garbage_collector::HeapBinding binding(&heap_);
+    if (stream_tokenizers_.empty() || stream_tokenizers_.back()->IsFinished()) {
+        stream_tokenizers_.push_back(std::make_unique<Tokenizer>());
+    }
+    stream_tokenizers_.back()->Feed(chunk);
+    if (stream_error_) {
+        std::rethrow_exception(std::exchange(stream_error_, nullptr));
+    }
+    return RunStreams();
+}
+
+std::optional<std::string> Interpreter::FinishFeed() {
+    garbage_collector::HeapBinding binding(&heap_);
+    if (stream_tokenizers_.empty()) {
+        return std::nullopt;
+    }
+    stream_tokenizers_.back()->FinishFeed();
+    if (stream_error_) {
+        std::rethrow_exception(std::exchange(stream_error_, nullptr));
+    }
+    return RunStreams();
+}
+
+std::optional<std::string> Interpreter::RunStreams() {
+    // a stream is dropped only after its last token, so that an error keeps the rest of it
+    std::optional<std::string> result;
+    try {
+        while (!stream_tokenizers_.empty()) {
+            Tokenizer* tokenizer = stream_tokenizers_.front().get();
+            RunForms(tokenizer, &stream_builder_, &result);
+            if (!tokenizer->IsFinished()) {
+                break;
+            }
+            stream_tokenizers_.pop_front();
+            if (stream_builder_.IsInsideForm()) {
+                stream_builder_.Reset();
+                throw SyntaxError("Expected ending of the list, no more tokens");
+            }
+        }
+    } catch (...) {
+        if (!result) {
+            throw;
+        }
+        stream_error_ = std::current_exception();  // the value would be lost otherwise
+    }
+    return result;
+}
+
+void Interpreter::RunForms(Tokenizer* tokenizer, FormBuilder* builder,
+                           std::optional<std::string>* result) {
+    while (!tokenizer->IsEnd()) {
+        std::optional<Object*> form;
+        try {
+            form = builder->Consume(tokenizer->GetToken());
+        } catch (const SyntaxError&) {
+            builder->Reset();
+            tokenizer->Next();
+            throw;
+        }
+        tokenizer->Next();
+        if (form) {
+            *result = GetRepr(EvaluateForm(*form));
+        }
+    }
+}
+
+std::optional<Object*> Interpreter::EvaluateForms(const std::vector<Object*>& forms) {
+    // only the value of the last form is needed, the others are not printed
+    std::optional<Object*> result;
+    for (size_t i = 0; i < forms.size(); ++i) {
+        result = EvaluateForm(forms[i], std::span(forms).subspan(i + 1));
+    }
     return result;
-}
\ No newline at end of file
+}
+
+Object* Interpreter::EvaluateForm(Object* form, std::span<Object* const> pending) {
+    // temporaries of the previous forms are needed only if they are reachable from variables
+    global_scope_->ClearServiceObjects();
+    if (garbage_collector::Instance().Size() >= next_collection_) {
+        CollectGarbage(form, pending);
+    }
+    return EvaluateObject(form, global_scope_);
+}
+
+void Interpreter::CollectGarbage(Object* form, std::span<Object* const> pending) {
+    // forms which are read but not evaluated yet are kept too
+    std::set<Object*> important = global_scope_->GatherReferredObjects();
+    for (Object* obj_ptr : pending) {
+        if (obj_ptr) {
+            obj_ptr->GatherSubobjects(important);
+        }
+    }
+    if (form) {
+        form->GatherSubobjects(important);
+    }
+    // a native may be shadowed or missing from a loaded image, but an image may still name it
+    for (const auto& [name, obj_ptr] : builtins_) {
+        obj_ptr->GatherSubobjects(important);
+    }
+    garbage_collector::Instance().CollectExcept(important);
+
+    // collections are amortized: the heap may double before the next one
+    next_collection_ = std::max(2 * garbage_collector::Instance().Size(), kMinCollectionSize);
+}
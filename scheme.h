@@ -1,18 +1,128 @@
 #pragma once
 
+#include "garbage_collector.h"
 #include "scope.h"
 #include "tokenizer.h"
 #include "parser.h"
+#include "native_function.h"
+#include "printer.h"
 #include "standart_functions.h"
 
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct BatchResult {
+    std::string value;         // repr of the last form, empty if the input failed or had no forms
+    std::exception_ptr error;  // what stopped evaluation of the input
+};
+
+class Builtins {
+    /*
+        Functions registered by the interpreter constructor. They keep no state of their own, so
+        one set may be shared read-only by interpreters running on different threads
+    */
+public:
+    Builtins();
+
+    const std::unordered_map<std::string, Object*>& GetFunctions() const {
+        return functions_;
+    }
+
+private:
+    garbage_collector::GarbageCollector heap_;  // never collected
+    std::unordered_map<std::string, Object*> functions_;
+};
 
 class Interpreter {
 public:
     Interpreter();
 
-    std::string Run(const std::string& command);
+    explicit Interpreter(std::shared_ptr<const Builtins> builtins);
+    /*
+        Every interpreter allocates on its own heap, so interpreters on different threads share
+        nothing but `builtins`. One interpreter must not be used by two threads at once
+    */
+
+    std::string Run(const std::string& command);  // every form is read before the first is run
+
+    void Run(const std::string& command, std::ostream* out, const PrintLimits& limits = {});
+    /*
+        Prints the value of the last form to `out` instead of building its repr, lists are printed
+        in one pass and may be truncated by `limits`
+    */
+
+    std::vector<BatchResult> RunBatch(std::span<const std::string> inputs);
+    /*
+        Runs independent inputs one after another in the same environment, an error stops only
+        its own input. The tokenizer and form buffers are shared by the whole batch, and garbage
+        is collected by the heap growth threshold, not per input
+    */
+
+    std::string RunFile(const std::string& path);  // the source is mapped, not read into memory
+
+    std::string RunCompiled(const std::string& path);  // image written by `compile-file`
+
+    std::string RunStream(std::istream* in);  // reads in chunks, memory does not grow with input
+
+    void SaveImage(const std::string& path);  // variables and every object reachable from them
+
+    void LoadImage(const std::string& path);  // replaces variables, builtins are kept
+
+    template <class F>
+    void RegisterNative(const std::string& name, F function) {
+        /*
+            Binds a C++ function or lambda as a builtin. Arguments are unboxed and checked by
+            their C++ types, see `NativeType`, and the result is boxed back. Natives of two
+            arguments take the same fast path as `+`. Registered natives are builtins for
+            `SaveImage` and `LoadImage`, so they must be registered before loading an image
+        */
+        garbage_collector::HeapBinding binding(&heap_);
+        builtins_[name] = global_scope_->CreateObject<NativeFunction<F>>(name, std::move(function));
+    }
+
+    /*
+        Incremental input: chunks may split tokens and lists anywhere, every form is evaluated
+        and released as soon as it is complete. Both return the repr of the last evaluated form.
+        After an error the unfinished form is dropped, the rest of the input is read by the next
+        call, which may be `Feed("")` or another `FinishFeed()`. An error after a value in the
+        same call is thrown by the next call instead, before it reads anything
+    */
+    std::optional<std::string> Feed(std::string_view chunk);
+
+    std::optional<std::string> FinishFeed();  // throws if the input ends inside of a form
+
+private:
+    constexpr static inline size_t kMinCollectionSize = 1 << 16;
+
+    // the repr of every evaluated form is stored into `result`, it is kept if a later form throws
+    void RunForms(Tokenizer* tokenizer, FormBuilder* builder, std::optional<std::string>* result);
+
+    std::optional<std::string> RunStreams();  // drops the streams which are read up to the end
+
+    std::optional<Object*> EvaluateForms(const std::vector<Object*>& forms);  // the last value
+
+    Object* EvaluateForm(Object* form, std::span<Object* const> pending = {});
+
+    void CollectGarbage(Object* form, std::span<Object* const> pending);
 
 private:
+    garbage_collector::GarbageCollector heap_;  // bound by every public method
+    std::shared_ptr<const Builtins> shared_builtins_;
     std::shared_ptr<Scope> global_scope_;
-};
\ No newline at end of file
+    // also the ones from `RegisterNative`, which are in `heap_` and kept by every collection
+    std::unordered_map<std::string, Object*> builtins_;
+    // a finished stream stays in front until it is read, chunks after it start the next one
+    std::deque<std::unique_ptr<Tokenizer>> stream_tokenizers_;
+    FormBuilder stream_builder_;
+    std::exception_ptr stream_error_;  // thrown by the next call, this one returned a value
+    size_t next_collection_ = 0;  // heap size, which triggers a collection before the next form
+};
@@ -14,6 +14,14 @@ std::optional<Object*> Scope::GetObjectInAncestorScope(const std::string& name)
     return (parent_scope_ && !res) ? parent_scope_->GetObjectInAncestorScope(name) : res;
 }
 
+Scope* Scope::GetDefiningScope(const std::string& name) {
+    Scope* scope = this;
+    while (scope && scope->objects_.find(name) == scope->objects_.end()) {
+        scope = scope->parent_scope_;
+    }
+    return scope;
+}
+
 Object* Scope::NameObject(Object* obj_ptr, const std::string& name) {
     // name should not be in scope already, or it may cause "memory leaks" in the interpreter
     // environment
@@ -21,6 +29,15 @@ Object* Scope::NameObject(Object* obj_ptr, const std::string& name) {
     return obj_ptr;
 }
 
+std::shared_ptr<Scope> Scope::Snapshot() const {
+    auto snapshot = std::make_shared<Scope>();
+    for (const Scope* scope = this; scope; scope = scope->parent_scope_) {
+        // `insert` keeps a name which is already taken by an inner scope
+        snapshot->objects_.insert(scope->objects_.begin(), scope->objects_.end());
+    }
+    return snapshot;
+}
+
 void GatherImpl(Scope* scope, std::set<Object*>& save) {
     for (auto [name, obj] : scope->objects_) {
         if (obj) {
@@ -41,6 +58,10 @@ std::set<Object*> Scope::GatherReferredObjects() {
     return result;
 }
 
+void Scope::ClearServiceObjects() {
+    service_objects_.clear();
+}
+
 Scope::~Scope() {
     // TODO: write custom destructor for calling `clear` in garbage_collector
 }
\ No newline at end of file
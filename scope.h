@@ -6,6 +6,7 @@
 
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -39,10 +40,24 @@ public:
 
     std::optional<Object*> GetObjectInAncestorScope(const std::string& name);
 
+    Scope* GetDefiningScope(const std::string& name);  // nullptr if the name is not defined
+
     Object* NameObject(Object* obj_ptr, const std::string& name);
 
+    const std::unordered_map<std::string, Object*>& GetObjectsInThisScope() const {
+        return objects_;
+    }
+
+    std::shared_ptr<Scope> Snapshot() const;
+    /*
+        Independent scope with every variable visible from this one, the innermost of equal names
+        wins. It does not change when this scope or its ancestors do
+    */
+
     std::set<Object*> GatherReferredObjects();
 
+    void ClearServiceObjects();  // once nothing refers to temporaries of finished evaluations
+
     ~Scope();
 
 private:
@@ -1,9 +1,20 @@
 #include "standart_functions.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
 #include <functional>
 #include <iterator>
+#include "compiled_forms.h"
+#include "data_reader.h"
 #include "error.h"
+#include "future.h"
+#include "garbage_collector.h"
+#include "memoized_function.h"
 #include "object.h"
+#include "task_scheduler.h"
+#include "vector_kernels.h"
 
 Object* Quote::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope>) {
     // assumming we were given list of length 1 and we return first element
@@ -52,317 +63,1469 @@ Object* OrFunction::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
 
 Object* IsNumber::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
     return scope->CreateServiceObject<Boolean>(
-        Is<Number>(EvaluateObject(cell_ptr->GetFirst(), scope)));
+        IsNumeric(EvaluateObject(cell_ptr->GetFirst(), scope)));
 }
 
-Object* Equal::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    return CheckOrderList(cell_ptr, scope, [&](Object* lhs, Object* rhs) {
-        if (!Is<Number>(lhs) || !Is<Number>(rhs)) {
-            throw RuntimeError("Cannot compare: `" + GetRepr(lhs) + "` and `" + GetRepr(rhs) + "`");
+int64_t GetNumberValue(Object* obj_ptr) {
+    if (!Is<Number>(obj_ptr)) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
+    }
+    return As<Number>(obj_ptr)->GetValue();
+}
+
+bool IsInteger(Object* obj_ptr) {
+    return Is<Number>(obj_ptr) || Is<BigNumber>(obj_ptr);
+}
+
+bool IsNumeric(Object* obj_ptr) {
+    return IsInteger(obj_ptr) || Is<Flonum>(obj_ptr);
+}
+
+double GetFlonumValue(Object* obj_ptr) {
+    if (Flonum* flonum_ptr = As<Flonum>(obj_ptr)) {
+        return flonum_ptr->GetValue();
+    }
+    if (Number* number_ptr = As<Number>(obj_ptr)) {
+        return static_cast<double>(number_ptr->GetValue());
+    }
+    if (BigNumber* big_number_ptr = As<BigNumber>(obj_ptr)) {
+        return big_number_ptr->GetValue().ToDouble();
+    }
+    throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
+}
+
+BigInteger GetBigIntegerValue(Object* obj_ptr) {
+    if (Number* number_ptr = As<Number>(obj_ptr)) {
+        return number_ptr->GetValue();
+    }
+    if (BigNumber* big_number_ptr = As<BigNumber>(obj_ptr)) {
+        return big_number_ptr->GetValue();
+    }
+    throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
+}
+
+Object* AbsoluteValue::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    Number* number_ptr = As<Number>(obj_ptr);
+    if (number_ptr && number_ptr->GetValue() != std::numeric_limits<int64_t>::min()) {
+        return CreateNumber(std::abs(number_ptr->GetValue()), scope);
+    }
+    if (Flonum* flonum_ptr = As<Flonum>(obj_ptr)) {
+        return scope->CreateServiceObject<Flonum>(std::fabs(flonum_ptr->GetValue()));
+    }
+    BigInteger value = GetBigIntegerValue(obj_ptr);
+    return CreateInteger(value.IsNegative() ? -value : value, scope);
+}
+
+Object* ExactToInexact::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (Is<Flonum>(obj_ptr)) {
+        return obj_ptr;
+    }
+    return scope->CreateServiceObject<Flonum>(GetFlonumValue(obj_ptr));
+}
+
+Object* InexactToExact::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (!Is<Flonum>(obj_ptr)) {
+        GetBigIntegerValue(obj_ptr);  // throws if not a number
+        return obj_ptr;
+    }
+
+    double value = As<Flonum>(obj_ptr)->GetValue();
+    if (!std::isfinite(value) || std::trunc(value) != value) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` has no exact representation");
+    }
+    if (std::fabs(value) < 9.2e18) {
+        return CreateNumber(static_cast<int64_t>(value), scope);
+    }
+    char digits[400];
+    std::snprintf(digits, sizeof(digits), "%.0f", value);
+    return CreateInteger(BigInteger::FromString(digits), scope);
+}
+
+Object* IsPair::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (obj_ptr && !Is<Cell>(obj_ptr)) {
+        return scope->CreateServiceObject<Boolean>(false);
+    }
+    auto objects = ListToVector(As<Cell>(obj_ptr));
+    return scope->CreateServiceObject<Boolean>(objects.size() == 2);
+}
+
+Object* IsNull::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (obj_ptr && !Is<Cell>(obj_ptr)) {
+        return scope->CreateServiceObject<Boolean>(false);
+    }
+    auto objects = ListToVector(As<Cell>(obj_ptr));
+    return scope->CreateServiceObject<Boolean>(objects.size() == 0);
+}
+
+bool CheckProperList(Cell* cell_ptr) {
+    while (cell_ptr) {
+        if (Is<Cell>(cell_ptr->GetSecond())) {
+            cell_ptr = As<Cell>(cell_ptr->GetSecond());
+        } else {
+            if (cell_ptr->GetSecond()) {
+                return false;
+            } else {
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+Object* IsList::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (obj_ptr && !Is<Cell>(obj_ptr)) {
+        return scope->CreateServiceObject<Boolean>(false);
+    }
+    return scope->CreateServiceObject<Boolean>(CheckProperList(As<Cell>(obj_ptr)));
+}
+
+Object* ConsOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> evaluated_objects;
+    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
+        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
+    });
+    return VectorToImproperList(evaluated_objects, scope);
+}
+
+Object* CarOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* evaluated_obj = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (!Is<Cell>(evaluated_obj)) {
+        throw RuntimeError("`car` argument should be pair, not: `" + GetRepr(evaluated_obj) + "`");
+    }
+    return As<Cell>(evaluated_obj)->GetFirst();
+}
+
+Object* CdrOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* evaluated_obj = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (!Is<Cell>(evaluated_obj)) {
+        throw RuntimeError("`cdr` argument should be pair, not: `" + GetRepr(evaluated_obj) + "`");
+    }
+    return As<Cell>(evaluated_obj)->GetSecond();
+}
+
+Object* ListMaker::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> evaluated_objects;
+    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
+        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
+    });
+    return VectorToProperList(evaluated_objects, scope);
+}
+
+Object* ListRef::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> evaluated_objects;
+    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
+        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
+    });
+    if (!Is<Number>(evaluated_objects[1])) {
+        throw RuntimeError("Second argument must be a number, but it is: `" +
+                           GetRepr(evaluated_objects[1]) + "`");
+    }
+    if (evaluated_objects[0] && !Is<Cell>(evaluated_objects[0])) {
+        throw RuntimeError("First argument must be a list, but it is: `" +
+                           GetRepr(evaluated_objects[0]) + "`");
+    }
+    Object* tail = FindKthTailInList(evaluated_objects[0], evaluated_objects[1]);
+    if (!Is<Cell>(tail)) {
+        // the index is equal to the size of the list
+        throw RuntimeError("Index is out of range: `" + GetRepr(evaluated_objects[1]) +
+                           "`, size: `" + GetRepr(evaluated_objects[1]) + "`");
+    }
+    return As<Cell>(tail)->GetFirst();
+}
+
+Object* FindKthTailInList(Object* list_ptr, Object* index_ptr) {
+    int64_t index = As<Number>(index_ptr)->GetValue();
+    Object* tail = list_ptr;
+    int64_t passed = 0;
+    while (passed < index && Is<Cell>(tail)) {
+        tail = As<Cell>(tail)->GetSecond();
+        ++passed;
+    }
+    if (index < 0 || passed < index) {
+        // the size is counted only to report it
+        for (; Is<Cell>(tail); tail = As<Cell>(tail)->GetSecond()) {
+            ++passed;
         }
-        return As<Number>(lhs)->GetValue() == As<Number>(rhs)->GetValue();
+        throw RuntimeError("Index is out of range: `" + GetRepr(index_ptr) + "`, size: `" +
+                           std::to_string(passed) + "`");
+    }
+    return tail;
+}
+
+Object* ListTail::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> evaluated_objects;
+    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
+        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
     });
+    if (!Is<Number>(evaluated_objects[1])) {
+        throw RuntimeError("Second argument must be a number, but it is: `" +
+                           GetRepr(evaluated_objects[1]) + "`");
+    }
+    if (evaluated_objects[0] && !Is<Cell>(evaluated_objects[0])) {
+        throw RuntimeError("First argument must be a list, but it is: `" +
+                           GetRepr(evaluated_objects[0]) + "`");
+    }
+    return FindKthTailInList(evaluated_objects[0], evaluated_objects[1]);
+}
+
+Cell* GetListCell(Object* obj_ptr) {
+    if (obj_ptr && !Is<Cell>(obj_ptr)) {
+        throw RuntimeError("Argument must be a proper list, but it is: `" + GetRepr(obj_ptr) +
+                           "`");
+    }
+    return As<Cell>(obj_ptr);
+}
+
+Function* GetFunction(Object* obj_ptr) {
+    if (!Is<Function>(obj_ptr)) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a function");
+    }
+    return As<Function>(obj_ptr);
+}
+
+bool IsFalse(Object* obj_ptr) {
+    return Is<Boolean>(obj_ptr) && !As<Boolean>(obj_ptr)->GetValue();
+}
+
+std::vector<Cell*> EvaluateLists(const std::vector<Object*>& objects, size_t from,
+                                 std::shared_ptr<Scope> scope) {
+    std::vector<Cell*> lists;
+    for (size_t i = from; i < objects.size(); ++i) {
+        lists.push_back(GetListCell(EvaluateObject(objects[i], scope)));
+    }
+    return lists;
+}
+
+bool NextListsRow(std::vector<Cell*>& lists, std::vector<Object*>* row) {
+    // takes the next element of every list, false once the shortest list is over
+    row->clear();
+    for (Cell* list_ptr : lists) {
+        if (!list_ptr) {
+            return false;
+        }
+    }
+    for (Cell*& list_ptr : lists) {
+        row->push_back(list_ptr->GetFirst());
+        list_ptr = GetListCell(list_ptr->GetSecond());
+    }
+    return true;
+}
+
+Object* LengthOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    int64_t length = 0;
+    Object* list_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    for (Cell* it = GetListCell(list_ptr); it; it = GetListCell(it->GetSecond())) {
+        ++length;
+    }
+    return CreateNumber(length, scope);
+}
+
+Object* AppendOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // every list but the last one is copied, the last one becomes the shared tail
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.empty()) {
+        return nullptr;
+    }
+
+    std::vector<Object*> elements;
+    for (size_t i = 0; i + 1 < objects.size(); ++i) {
+        Object* list_ptr = EvaluateObject(objects[i], scope);
+        for (Cell* it = GetListCell(list_ptr); it; it = GetListCell(it->GetSecond())) {
+            elements.push_back(it->GetFirst());
+        }
+    }
+
+    Object* tail = EvaluateObject(objects.back(), scope);
+    if (elements.empty()) {
+        return tail;
+    }
+    elements.push_back(tail);
+    return VectorToImproperList(elements, scope);
+}
+
+Object* ReverseOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* result = nullptr;
+    Object* list_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    for (Cell* it = GetListCell(list_ptr); it; it = GetListCell(it->GetSecond())) {
+        Cell* new_cell = scope->CreateServiceObject<Cell>();
+        new_cell->GetFirst() = it->GetFirst();
+        new_cell->GetSecond() = result;
+        result = new_cell;
+    }
+    return result;
+}
+
+Object* MapOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 2) {
+        throw RuntimeError("`map` expects a function and at least one list");
+    }
+
+    Function* function_ptr = GetFunction(EvaluateObject(objects[0], scope));
+    std::vector<Cell*> lists = EvaluateLists(objects, 1, scope);
+    std::vector<Object*> row;
+    std::vector<Object*> results;
+    while (NextListsRow(lists, &row)) {
+        results.push_back(function_ptr->Apply(row, scope));
+    }
+    return VectorToProperList(results, scope);
+}
+
+Object* FilterOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Function* function_ptr = GetFunction(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* list_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    std::vector<Object*> results;
+    for (Cell* it = GetListCell(list_ptr); it; it = GetListCell(it->GetSecond())) {
+        if (!IsFalse(function_ptr->Apply({it->GetFirst()}, scope))) {
+            results.push_back(it->GetFirst());
+        }
+    }
+    return VectorToProperList(results, scope);
+}
+
+Object* FoldLeftOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(fold-left f init l1 l2 ...)` computes `(f (f init x1 y1 ...) x2 y2 ...)`
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 3) {
+        throw RuntimeError("`fold-left` expects a function, initial value and lists");
+    }
+
+    Function* function_ptr = GetFunction(EvaluateObject(objects[0], scope));
+    Object* result = EvaluateObject(objects[1], scope);
+    std::vector<Cell*> lists = EvaluateLists(objects, 2, scope);
+    std::vector<Object*> row;
+    while (NextListsRow(lists, &row)) {
+        row.insert(row.begin(), result);
+        result = function_ptr->Apply(row, scope);
+    }
+    return result;
+}
+
+Object* FoldRightOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(fold-right f init l1 l2 ...)` computes `(f x1 y1 ... (f x2 y2 ... init))`
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 3) {
+        throw RuntimeError("`fold-right` expects a function, initial value and lists");
+    }
+
+    Function* function_ptr = GetFunction(EvaluateObject(objects[0], scope));
+    Object* result = EvaluateObject(objects[1], scope);
+    std::vector<Cell*> lists = EvaluateLists(objects, 2, scope);
+    std::vector<std::vector<Object*>> rows(1);
+    while (NextListsRow(lists, &rows.back())) {
+        rows.emplace_back();
+    }
+    rows.pop_back();
+    for (auto it = rows.rbegin(); it != rows.rend(); ++it) {
+        it->push_back(result);
+        result = function_ptr->Apply(*it, scope);
+    }
+    return result;
+}
+
+Object* ForEachOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 2) {
+        throw RuntimeError("`for-each` expects a function and at least one list");
+    }
+
+    Function* function_ptr = GetFunction(EvaluateObject(objects[0], scope));
+    std::vector<Cell*> lists = EvaluateLists(objects, 1, scope);
+    std::vector<Object*> row;
+    while (NextListsRow(lists, &row)) {
+        function_ptr->Apply(row, scope);
+    }
+    return nullptr;
+}
+
+Vector* GetVector(Object* obj_ptr) {
+    if (!Is<Vector>(obj_ptr)) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a vector");
+    }
+    return As<Vector>(obj_ptr);
+}
+
+size_t GetIndex(Object* obj_ptr, size_t size) {
+    if (!Is<Number>(obj_ptr)) {
+        throw RuntimeError("Index must be a number, but it is: `" + GetRepr(obj_ptr) + "`");
+    }
+    int64_t index = As<Number>(obj_ptr)->GetValue();
+    if (index < 0 || static_cast<size_t>(index) >= size) {
+        throw RuntimeError("Index is out of range: `" + GetRepr(obj_ptr) + "`, size: `" +
+                           std::to_string(size) + "`");
+    }
+    return index;
+}
+
+Object* IsVector::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return GetBooleanConstant(Is<Vector>(EvaluateObject(cell_ptr->GetFirst(), scope)));
+}
+
+Object* MakeVector::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.empty() || objects.size() > 2) {
+        throw RuntimeError("`make-vector` expects size and optional fill value");
+    }
+
+    Object* size_ptr = EvaluateObject(objects[0], scope);
+    if (!Is<Number>(size_ptr) || As<Number>(size_ptr)->GetValue() < 0) {
+        throw RuntimeError("Size must be a non-negative number, but it is: `" +
+                           GetRepr(size_ptr) + "`");
+    }
+    Object* fill_ptr =
+        objects.size() == 2 ? EvaluateObject(objects[1], scope) : CreateNumber(0, scope);
+
+    return scope->CreateServiceObject<Vector>(
+        std::vector<Object*>(As<Number>(size_ptr)->GetValue(), fill_ptr));
+}
+
+Object* VectorMaker::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> elements;
+    ApplyToList(cell_ptr,
+                [&](Object* obj_ptr) { elements.push_back(EvaluateObject(obj_ptr, scope)); });
+    return scope->CreateServiceObject<Vector>(std::move(elements));
+}
+
+Object* VectorRef::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Vector* vector_ptr = GetVector(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* index_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    return vector_ptr->GetElements()[GetIndex(index_ptr, vector_ptr->GetElements().size())];
+}
+
+Object* VectorSet::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    Vector* vector_ptr = GetVector(EvaluateObject(objects[0], scope));
+    size_t index = GetIndex(EvaluateObject(objects[1], scope), vector_ptr->GetElements().size());
+    vector_ptr->GetElements()[index] = EvaluateObject(objects[2], scope);
+    return vector_ptr;
+}
+
+Object* VectorLength::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Vector* vector_ptr = GetVector(EvaluateObject(cell_ptr->GetFirst(), scope));
+    return CreateNumber(vector_ptr->GetElements().size(), scope);
+}
+
+Object* VectorToList::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Vector* vector_ptr = GetVector(EvaluateObject(cell_ptr->GetFirst(), scope));
+    return VectorToProperList(vector_ptr->GetElements(), scope);
+}
+
+Object* ListToVectorOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* list_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (list_ptr && (!Is<Cell>(list_ptr) || !CheckProperList(As<Cell>(list_ptr)))) {
+        throw RuntimeError("Argument must be a proper list, but it is: `" + GetRepr(list_ptr) +
+                           "`");
+    }
+    return scope->CreateServiceObject<Vector>(ListToVector(As<Cell>(list_ptr)));
+}
+
+VectorKind ClassifyVector(const std::vector<Object*>& elements) {
+    // sums of 32-bit values cannot overflow while there are less than 2^32 of them
+    VectorKind kind = elements.size() < (size_t(1) << 32) ? VectorKind::SmallFixnums
+                                                          : VectorKind::Fixnums;
+    for (Object* obj_ptr : elements) {
+        if (Number* number_ptr = As<Number>(obj_ptr)) {
+            int64_t value = number_ptr->GetValue();
+            if (value < std::numeric_limits<int32_t>::min() ||
+                value > std::numeric_limits<int32_t>::max()) {
+                kind = std::max(kind, VectorKind::Fixnums);
+            }
+        } else if (Is<BigNumber>(obj_ptr)) {
+            kind = std::max(kind, VectorKind::Exact);
+        } else if (Is<Flonum>(obj_ptr)) {
+            kind = VectorKind::Inexact;
+        } else {
+            throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
+        }
+    }
+    return kind;
+}
+
+std::vector<int64_t> UnboxIntegers(const std::vector<Object*>& elements) {  // fixnums only
+    std::vector<int64_t> values(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        values[i] = As<Number>(elements[i])->GetValue();
+    }
+    return values;
+}
+
+std::vector<double> UnboxFloats(const std::vector<Object*>& elements) {
+    std::vector<double> values(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        values[i] = GetFlonumValue(elements[i]);
+    }
+    return values;
+}
+
+std::pair<Vector*, Vector*> GetVectorsOfEqualSize(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Vector* lhs = GetVector(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Vector* rhs = GetVector(EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope));
+    if (lhs->GetElements().size() != rhs->GetElements().size()) {
+        throw RuntimeError("Vectors have different sizes: `" + GetRepr(lhs) + "` and `" +
+                           GetRepr(rhs) + "`");
+    }
+    return {lhs, rhs};
+}
+
+Object* VectorSum::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    const auto& elements = GetVector(EvaluateObject(cell_ptr->GetFirst(), scope))->GetElements();
+    switch (ClassifyVector(elements)) {
+        case VectorKind::SmallFixnums: {
+            std::vector<int64_t> values = UnboxIntegers(elements);
+            return CreateNumber(SumSmallIntegers(values.data(), values.size()), scope);
+        }
+        case VectorKind::Inexact: {
+            std::vector<double> values = UnboxFloats(elements);
+            return scope->CreateServiceObject<Flonum>(SumFloats(values.data(), values.size()));
+        }
+        default: {
+            Object* result = CreateNumber(0, scope);
+            Addition addition;
+            for (Object* obj_ptr : elements) {
+                result = addition.InvokeBinary(result, obj_ptr, scope);
+            }
+            return result;
+        }
+    }
+}
+
+Object* VectorDot::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    auto [lhs, rhs] = GetVectorsOfEqualSize(cell_ptr, scope);
+    const auto& lhs_elements = lhs->GetElements();
+    const auto& rhs_elements = rhs->GetElements();
+    VectorKind kind = std::max(ClassifyVector(lhs_elements), ClassifyVector(rhs_elements));
+    if (kind == VectorKind::Inexact) {
+        std::vector<double> lhs_values = UnboxFloats(lhs_elements);
+        std::vector<double> rhs_values = UnboxFloats(rhs_elements);
+        return scope->CreateServiceObject<Flonum>(
+            DotFloats(lhs_values.data(), rhs_values.data(), lhs_values.size()));
+    }
+
+    if (kind != VectorKind::Exact) {
+        int64_t result = 0;
+        bool overflow = false;
+        for (size_t i = 0; i < lhs_elements.size() && !overflow; ++i) {
+            int64_t product = 0;
+            overflow = __builtin_mul_overflow(As<Number>(lhs_elements[i])->GetValue(),
+                                              As<Number>(rhs_elements[i])->GetValue(), &product) ||
+                       __builtin_add_overflow(result, product, &result);
+        }
+        if (!overflow) {
+            return CreateNumber(result, scope);
+        }
+    }
+
+    Object* result = CreateNumber(0, scope);
+    Addition addition;
+    Multiplication multiplication;
+    for (size_t i = 0; i < lhs_elements.size(); ++i) {
+        Object* product = multiplication.InvokeBinary(lhs_elements[i], rhs_elements[i], scope);
+        result = addition.InvokeBinary(result, product, scope);
+    }
+    return result;
+}
+
+template <class Operation>
+Object* VectorExtremum(Cell* cell_ptr, std::shared_ptr<Scope> scope, bool minimum) {
+    const auto& elements = GetVector(EvaluateObject(cell_ptr->GetFirst(), scope))->GetElements();
+    if (elements.empty()) {
+        throw RuntimeError(std::string("No arguments for `") + Operation::kName + "` operation");
+    }
+    switch (ClassifyVector(elements)) {
+        case VectorKind::SmallFixnums:
+        case VectorKind::Fixnums: {
+            std::vector<int64_t> values = UnboxIntegers(elements);
+            return CreateNumber(minimum ? MinIntegers(values.data(), values.size())
+                                        : MaxIntegers(values.data(), values.size()),
+                                scope);
+        }
+        case VectorKind::Inexact: {
+            std::vector<double> values = UnboxFloats(elements);
+            return scope->CreateServiceObject<Flonum>(
+                minimum ? MinFloats(values.data(), values.size())
+                        : MaxFloats(values.data(), values.size()));
+        }
+        default: {
+            Object* result = elements[0];
+            NumericFold<Operation> function;
+            for (Object* obj_ptr : elements) {
+                result = function.InvokeBinary(result, obj_ptr, scope);
+            }
+            return result;
+        }
+    }
+}
+
+Object* VectorMin::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return VectorExtremum<MinimumOperation>(cell_ptr, scope, true);
+}
+
+Object* VectorMax::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return VectorExtremum<MaximumOperation>(cell_ptr, scope, false);
+}
+
+void BoxIntegers(const std::vector<int64_t>& values, Vector* vector_ptr,
+                 std::shared_ptr<Scope> scope) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        vector_ptr->GetElements()[i] = CreateNumber(values[i], scope);
+    }
+}
+
+void BoxFloats(const std::vector<double>& values, Vector* vector_ptr,
+               std::shared_ptr<Scope> scope) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        vector_ptr->GetElements()[i] = scope->CreateServiceObject<Flonum>(values[i]);
+    }
+}
+
+Object* VectorAdd::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    auto [lhs, rhs] = GetVectorsOfEqualSize(cell_ptr, scope);
+    auto& lhs_elements = lhs->GetElements();
+    const auto& rhs_elements = rhs->GetElements();
+    switch (std::max(ClassifyVector(lhs_elements), ClassifyVector(rhs_elements))) {
+        case VectorKind::SmallFixnums: {
+            std::vector<int64_t> values = UnboxIntegers(lhs_elements);
+            std::vector<int64_t> addends = UnboxIntegers(rhs_elements);
+            AddSmallIntegers(values.data(), addends.data(), values.size());
+            BoxIntegers(values, lhs, scope);
+            break;
+        }
+        case VectorKind::Inexact: {
+            std::vector<double> values = UnboxFloats(lhs_elements);
+            std::vector<double> addends = UnboxFloats(rhs_elements);
+            AddFloats(values.data(), addends.data(), values.size());
+            BoxFloats(values, lhs, scope);
+            break;
+        }
+        default: {
+            Addition addition;
+            for (size_t i = 0; i < lhs_elements.size(); ++i) {
+                lhs_elements[i] = addition.InvokeBinary(lhs_elements[i], rhs_elements[i], scope);
+            }
+        }
+    }
+    return lhs;
+}
+
+Object* VectorScale::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Vector* vector_ptr = GetVector(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* factor = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    auto& elements = vector_ptr->GetElements();
+    switch (std::max(ClassifyVector(elements), ClassifyVector({factor}))) {
+        case VectorKind::SmallFixnums: {
+            std::vector<int64_t> values = UnboxIntegers(elements);
+            ScaleSmallIntegers(values.data(), values.size(), As<Number>(factor)->GetValue());
+            BoxIntegers(values, vector_ptr, scope);
+            break;
+        }
+        case VectorKind::Inexact: {
+            std::vector<double> values = UnboxFloats(elements);
+            ScaleFloats(values.data(), values.size(), GetFlonumValue(factor));
+            BoxFloats(values, vector_ptr, scope);
+            break;
+        }
+        default: {
+            Multiplication multiplication;
+            for (Object*& obj_ptr : elements) {
+                obj_ptr = multiplication.InvokeBinary(obj_ptr, factor, scope);
+            }
+        }
+    }
+    return vector_ptr;
+}
+
+std::optional<KernelComparison> GetKernelComparison(Object* function_ptr) {
+    if (Is<Less>(function_ptr)) {
+        return KernelComparison::Less;
+    }
+    if (Is<Greater>(function_ptr)) {
+        return KernelComparison::Greater;
+    }
+    if (Is<Equal>(function_ptr)) {
+        return KernelComparison::Equal;
+    }
+    if (Is<LessEqual>(function_ptr)) {
+        return KernelComparison::LessEqual;
+    }
+    if (Is<GreaterEqual>(function_ptr)) {
+        return KernelComparison::GreaterEqual;
+    }
+    return std::nullopt;
+}
+
+Object* VectorCountIf::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(vector-count-if < v 10)` counts elements `x` such that `(< x 10)`, numeric comparisons
+    // are run by kernels and any other predicate is called for every element
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    Object* function_ptr = EvaluateObject(objects[0], scope);
+    const auto& elements = GetVector(EvaluateObject(objects[1], scope))->GetElements();
+    Object* threshold = EvaluateObject(objects[2], scope);
+
+    if (auto comparison = GetKernelComparison(function_ptr)) {
+        VectorKind kind = std::max(ClassifyVector(elements), ClassifyVector({threshold}));
+        if (kind == VectorKind::Inexact) {
+            std::vector<double> values = UnboxFloats(elements);
+            return CreateNumber(CountFloats(values.data(), values.size(), *comparison,
+                                            GetFlonumValue(threshold)),
+                                scope);
+        }
+        if (kind != VectorKind::Exact) {
+            std::vector<int64_t> values = UnboxIntegers(elements);
+            return CreateNumber(CountIntegers(values.data(), values.size(), *comparison,
+                                              As<Number>(threshold)->GetValue()),
+                                scope);
+        }
+    }
+
+    int64_t result = 0;
+    for (Object* obj_ptr : elements) {
+        result += !IsFalse(GetFunction(function_ptr)->Apply({obj_ptr, threshold}, scope));
+    }
+    return CreateNumber(result, scope);
+}
+
+Bytevector* GetBytevector(Object* obj_ptr) {
+    if (!Is<Bytevector>(obj_ptr)) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a bytevector");
+    }
+    return As<Bytevector>(obj_ptr);
+}
+
+uint8_t GetByteValue(Object* obj_ptr) {
+    if (!Is<Number>(obj_ptr) || As<Number>(obj_ptr)->GetValue() < 0 ||
+        As<Number>(obj_ptr)->GetValue() > 255) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a byte");
+    }
+    return As<Number>(obj_ptr)->GetValue();
+}
+
+Object* IsBytevector::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return GetBooleanConstant(Is<Bytevector>(EvaluateObject(cell_ptr->GetFirst(), scope)));
+}
+
+Object* MakeBytevector::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.empty() || objects.size() > 2) {
+        throw RuntimeError("`make-bytevector` expects size and optional fill byte");
+    }
+
+    Object* size_ptr = EvaluateObject(objects[0], scope);
+    if (!Is<Number>(size_ptr) || As<Number>(size_ptr)->GetValue() < 0) {
+        throw RuntimeError("Size must be a non-negative number, but it is: `" +
+                           GetRepr(size_ptr) + "`");
+    }
+    uint8_t fill = 0;
+    if (objects.size() == 2) {
+        fill = GetByteValue(EvaluateObject(objects[1], scope));
+    }
+    return scope->CreateServiceObject<Bytevector>(As<Number>(size_ptr)->GetValue(), fill);
+}
+
+Object* BytevectorU8Ref::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Bytevector* bytes_ptr = GetBytevector(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* index_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    return CreateNumber(bytes_ptr->GetData()[GetIndex(index_ptr, bytes_ptr->Size())], scope);
+}
+
+Object* BytevectorU8Set::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    Bytevector* bytes_ptr = GetBytevector(EvaluateObject(objects[0], scope));
+    size_t index = GetIndex(EvaluateObject(objects[1], scope), bytes_ptr->Size());
+    uint8_t value = GetByteValue(EvaluateObject(objects[2], scope));
+    bytes_ptr->GetMutableData()[index] = value;
+    return bytes_ptr;
+}
+
+Object* BytevectorS64Ref::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // native byte order, the offset does not have to be aligned
+    Bytevector* bytes_ptr = GetBytevector(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* index_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    size_t size = bytes_ptr->Size();
+    size_t offset = GetIndex(index_ptr, size < sizeof(int64_t) ? 0 : size - sizeof(int64_t) + 1);
+    int64_t value = 0;
+    std::memcpy(&value, bytes_ptr->GetData() + offset, sizeof(value));
+    return CreateNumber(value, scope);
+}
+
+Object* BytevectorLength::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return CreateNumber(GetBytevector(EvaluateObject(cell_ptr->GetFirst(), scope))->Size(), scope);
+}
+
+Object* MmapFile::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    const std::string& path = GetStringValue(EvaluateObject(cell_ptr->GetFirst(), scope));
+    return scope->CreateServiceObject<Bytevector>(path);
+}
+
+Object* CompileFileFunction::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // returns the number of compiled forms
+    const std::string& source = GetStringValue(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* output_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    return CreateNumber(CompileFile(source, GetStringValue(output_ptr)), scope);
+}
+
+Object* ReadFunction::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // bytevectors let large data files be read straight from `mmap-file`
+    Object* source_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (Bytevector* bytevector = As<Bytevector>(source_ptr)) {
+        const char* data = reinterpret_cast<const char*>(bytevector->GetData());
+        return ReadDatum(std::string_view(data, bytevector->Size()));
+    }
+    return ReadDatum(GetStringValue(source_ptr));
+}
+
+const std::string& GetStringValue(Object* obj_ptr) {
+    if (!Is<String>(obj_ptr)) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a string");
+    }
+    return As<String>(obj_ptr)->GetValue();
+}
+
+Object* IsString::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return GetBooleanConstant(Is<String>(EvaluateObject(cell_ptr->GetFirst(), scope)));
+}
+
+Object* StringLength::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return CreateNumber(GetStringValue(EvaluateObject(cell_ptr->GetFirst(), scope)).size(), scope);
+}
+
+Object* StringRef::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // there is no character type, so the character is returned as a string of length 1
+    const std::string& str = GetStringValue(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* index_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    return scope->CreateServiceObject<String>(std::string(1, str[GetIndex(index_ptr, str.size())]));
+}
+
+Object* Substring::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 2 || objects.size() > 3) {
+        throw RuntimeError("`substring` expects string, start and optional end");
+    }
+
+    const std::string& str = GetStringValue(EvaluateObject(objects[0], scope));
+    // both bounds may be equal to the length of the string
+    size_t start = GetIndex(EvaluateObject(objects[1], scope), str.size() + 1);
+    size_t end = objects.size() == 3 ? GetIndex(EvaluateObject(objects[2], scope), str.size() + 1)
+                                     : str.size();
+    if (start > end) {
+        throw RuntimeError("Start of substring is greater than its end");
+    }
+    return scope->CreateServiceObject<String>(str.substr(start, end - start));
+}
+
+Object* StringAppend::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> strings;
+    size_t total_size = 0;
+    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
+        strings.push_back(EvaluateObject(obj_ptr, scope));
+        total_size += GetStringValue(strings.back()).size();
+    });
+
+    std::string result;
+    result.reserve(total_size);
+    for (Object* obj_ptr : strings) {
+        result += As<String>(obj_ptr)->GetValue();
+    }
+    return scope->CreateServiceObject<String>(std::move(result));
+}
+
+Object* StringEqual::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return CheckOrderList(cell_ptr, scope, [](Object* lhs, Object* rhs) {
+        return GetStringValue(lhs) == GetStringValue(rhs);
+    });
+}
+
+Object* MakeStringBuilder::InvokeImpl(Cell*, std::shared_ptr<Scope> scope) {
+    return scope->CreateServiceObject<StringBuilder>();
+}
+
+Object* StringBuilderAppend::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.empty()) {
+        throw RuntimeError("`string-builder-append!` expects string builder");
+    }
+
+    Object* builder_ptr = EvaluateObject(objects[0], scope);
+    if (!Is<StringBuilder>(builder_ptr)) {
+        throw RuntimeError("`" + GetRepr(builder_ptr) + "` is not a string builder");
+    }
+    std::string& buffer = As<StringBuilder>(builder_ptr)->GetBuffer();
+    for (size_t i = 1; i < objects.size(); ++i) {
+        // strings are appended as they are, other objects by their representation
+        Object* obj_ptr = EvaluateObject(objects[i], scope);
+        if (String* string_ptr = As<String>(obj_ptr)) {
+            buffer += string_ptr->GetValue();
+        } else {
+            buffer += GetRepr(obj_ptr);
+        }
+    }
+    return builder_ptr;
+}
+
+Object* StringBuilderToString::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* builder_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (!Is<StringBuilder>(builder_ptr)) {
+        throw RuntimeError("`" + GetRepr(builder_ptr) + "` is not a string builder");
+    }
+    return scope->CreateServiceObject<String>(As<StringBuilder>(builder_ptr)->GetBuffer());
+}
+
+HashTable* GetHashTable(Object* obj_ptr) {
+    if (!Is<HashTable>(obj_ptr)) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a hash table");
+    }
+    return As<HashTable>(obj_ptr);
+}
+
+Object* IsHashTable::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return GetBooleanConstant(Is<HashTable>(EvaluateObject(cell_ptr->GetFirst(), scope)));
+}
+
+Object* MakeHashTable::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(make-hash-table)` compares keys with `equal?`, `(make-hash-table 'eqv)` by identity
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() > 1) {
+        throw RuntimeError("`make-hash-table` expects optional equivalence");
+    }
+
+    HashTable::Equivalence equivalence = HashTable::Equivalence::Equal;
+    if (objects.size() == 1) {
+        Object* obj_ptr = EvaluateObject(objects[0], scope);
+        std::string name = Is<Symbol>(obj_ptr) ? As<Symbol>(obj_ptr)->GetName() : "";
+        if (name == "eq" || name == "eqv" || name == "eq?" || name == "eqv?") {
+            equivalence = HashTable::Equivalence::Eqv;
+        } else if (name != "equal" && name != "equal?") {
+            throw RuntimeError("Unknown equivalence: `" + GetRepr(obj_ptr) + "`");
+        }
+    }
+    return scope->CreateServiceObject<HashTable>(equivalence);
+}
+
+Object* HashTableRef::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // default value is evaluated only if there is no such key
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 2 || objects.size() > 3) {
+        throw RuntimeError("`hash-table-ref` expects table, key and optional default");
+    }
+
+    HashTable* table_ptr = GetHashTable(EvaluateObject(objects[0], scope));
+    Object* key_ptr = EvaluateObject(objects[1], scope);
+    if (Object* value_ptr = table_ptr->Find(key_ptr); value_ptr || table_ptr->Contains(key_ptr)) {
+        return value_ptr;
+    }
+    if (objects.size() == 3) {
+        return EvaluateObject(objects[2], scope);
+    }
+    throw RuntimeError("No such key in hash table: `" + GetRepr(key_ptr) + "`");
+}
+
+Object* HashTableSet::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    HashTable* table_ptr = GetHashTable(EvaluateObject(objects[0], scope));
+    Object* key_ptr = EvaluateObject(objects[1], scope);
+    if (table_ptr->GetEquivalence() == HashTable::Equivalence::Equal) {
+        // structural keys are copied, so that later `set-car!` on them cannot change the key
+        key_ptr = CopyObject(key_ptr, scope);
+    }
+    table_ptr->Insert(key_ptr, EvaluateObject(objects[2], scope));
+    return table_ptr;
+}
+
+Object* HashTableDelete::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    HashTable* table_ptr = GetHashTable(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* key_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    return GetBooleanConstant(table_ptr->Erase(key_ptr));
+}
+
+Object* HashTableCount::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return CreateNumber(GetHashTable(EvaluateObject(cell_ptr->GetFirst(), scope))->Size(), scope);
+}
+
+Object* HashTableContains::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    HashTable* table_ptr = GetHashTable(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Object* key_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+    return GetBooleanConstant(table_ptr->Contains(key_ptr));
+}
+
+Object* HashTableKeys::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> keys;
+    GetHashTable(EvaluateObject(cell_ptr->GetFirst(), scope))
+        ->ForEach([&](Object* key, Object*) { keys.push_back(key); });
+    return VectorToProperList(keys, scope);
+}
+
+Object* HashTableValues::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> values;
+    GetHashTable(EvaluateObject(cell_ptr->GetFirst(), scope))
+        ->ForEach([&](Object*, Object* value) { values.push_back(value); });
+    return VectorToProperList(values, scope);
+}
+
+Object* HashTableToAlist::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> pairs;
+    GetHashTable(EvaluateObject(cell_ptr->GetFirst(), scope))
+        ->ForEach([&](Object* key, Object* value) {
+            pairs.push_back(VectorToImproperList({key, value}, scope));
+        });
+    return VectorToProperList(pairs, scope);
+}
+
+Object* HashTableWalk::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    HashTable* table_ptr = GetHashTable(EvaluateObject(cell_ptr->GetFirst(), scope));
+    Function* function_ptr =
+        GetFunction(EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope));
+
+    // the procedure may modify the table, so entries are collected before calling it
+    std::vector<std::pair<Object*, Object*>> entries;
+    table_ptr->ForEach([&](Object* key, Object* value) { entries.emplace_back(key, value); });
+    for (auto [key, value] : entries) {
+        function_ptr->Apply({key, value}, scope);
+    }
+    return nullptr;
 }
 
-Object* Less::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    return CheckOrderList(cell_ptr, scope, [&](Object* lhs, Object* rhs) {
-        if (!Is<Number>(lhs) || !Is<Number>(rhs)) {
-            throw RuntimeError("Cannot compare: `" + GetRepr(lhs) + "` and `" + GetRepr(rhs) + "`");
-        }
-        return As<Number>(lhs)->GetValue() < As<Number>(rhs)->GetValue();
-    });
+Object* IfStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // arguments quantity control is on InvokeImpl now, because we want to throw SyntaxError
+    // instead of RuntimeError in this function
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 2 || objects.size() > 3) {
+        throw SyntaxError("Incorrect number of parameters for if statement");
+    }
+
+    Object* statement = EvaluateObject(objects[0], scope);
+    if (!IsBooleanConstant(statement)) {
+        throw RuntimeError("Statement value should be bool");
+    }
+
+    if (GetRepr(statement) == "#t") {
+        return EvaluateObject(objects[1], scope);
+    } else {
+        return (objects.size() == 3) ? EvaluateObject(objects[2], scope) : nullptr;
+    }
 }
 
-Object* Greater::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    return CheckOrderList(cell_ptr, scope, [&](Object* lhs, Object* rhs) {
-        if (!Is<Number>(lhs) || !Is<Number>(rhs)) {
-            throw RuntimeError("Cannot compare: `" + GetRepr(lhs) + "` and `" + GetRepr(rhs) + "`");
-        }
-        return As<Number>(lhs)->GetValue() > As<Number>(rhs)->GetValue();
-    });
+Object* EvaluateSequence(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* result = nullptr;
+    ApplyToList(cell_ptr, [&](Object* obj_ptr) { result = EvaluateObject(obj_ptr, scope); });
+    return result;
 }
 
-Object* LessEqual::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    return CheckOrderList(cell_ptr, scope, [&](Object* lhs, Object* rhs) {
-        if (!Is<Number>(lhs) || !Is<Number>(rhs)) {
-            throw RuntimeError("Cannot compare: `" + GetRepr(lhs) + "` and `" + GetRepr(rhs) + "`");
+std::vector<std::pair<Symbol*, Object*>> ParseBindings(Object* bindings_ptr) {
+    if (bindings_ptr && !Is<Cell>(bindings_ptr)) {
+        throw SyntaxError("Bindings must be a list");
+    }
+
+    std::vector<std::pair<Symbol*, Object*>> bindings;
+    ApplyToList(As<Cell>(bindings_ptr), [&](Object* obj_ptr) {
+        Cell* binding_ptr = As<Cell>(obj_ptr);
+        Cell* rest_ptr = binding_ptr ? As<Cell>(binding_ptr->GetSecond()) : nullptr;
+        if (!binding_ptr || !Is<Symbol>(binding_ptr->GetFirst()) || !rest_ptr ||
+            rest_ptr->GetSecond()) {
+            throw SyntaxError("Binding must be a name and an expression, but it is: `" +
+                              GetRepr(obj_ptr) + "`");
         }
-        return As<Number>(lhs)->GetValue() <= As<Number>(rhs)->GetValue();
+        bindings.emplace_back(As<Symbol>(binding_ptr->GetFirst()), rest_ptr->GetFirst());
     });
+    return bindings;
 }
 
-Object* GreaterEqual::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    return CheckOrderList(cell_ptr, scope, [&](Object* lhs, Object* rhs) {
-        if (!Is<Number>(lhs) || !Is<Number>(rhs)) {
-            throw RuntimeError("Cannot compare: `" + GetRepr(lhs) + "` and `" + GetRepr(rhs) + "`");
-        }
-        return As<Number>(lhs)->GetValue() >= As<Number>(rhs)->GetValue();
-    });
+Cell* GetFormBody(Cell* cell_ptr, const std::string& form) {
+    Cell* body_ptr = As<Cell>(cell_ptr->GetSecond());
+    if (!body_ptr) {
+        throw SyntaxError("Body of `" + form + "` is empty");
+    }
+    return body_ptr;
 }
 
-Object* Addition::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    int64_t result = 0;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        obj_ptr = EvaluateObject(obj_ptr, scope);
-        if (!Is<Number>(obj_ptr)) {
-            throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
-        }
-        result += As<Number>(obj_ptr)->GetValue();
-    });
-    return scope->CreateServiceObject<Number>(result);
+Object* BeginStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return EvaluateSequence(cell_ptr, scope);
 }
 
-Object* Subtraction::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::optional<int64_t> result;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        obj_ptr = EvaluateObject(obj_ptr, scope);
-        if (!Is<Number>(obj_ptr)) {
-            throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
-        }
-        if (!result) {
-            result = As<Number>(obj_ptr)->GetValue();
-        } else {
-            *result -= As<Number>(obj_ptr)->GetValue();
-        }
-    });
-    if (!result) {
-        throw RuntimeError("No arguments for `-` operation");
+Object* LetStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // unlike an applied lambda, nothing is captured: the body runs in a plain child frame
+    if (!cell_ptr) {
+        throw SyntaxError("Empty `let`");
     }
+    if (Is<Symbol>(cell_ptr->GetFirst())) {
+        return EvaluateNamedLet(cell_ptr, scope);
+    }
+    auto bindings = ParseBindings(cell_ptr->GetFirst());
+    Cell* body_ptr = GetFormBody(cell_ptr, "let");
 
-    return scope->CreateServiceObject<Number>(*result);
-}
+    std::vector<Object*> values;
+    for (auto [symbol_ptr, expression] : bindings) {
+        values.push_back(EvaluateObject(expression, scope));
+    }
 
-Object* Multiplication::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    int64_t result = 1;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        obj_ptr = EvaluateObject(obj_ptr, scope);
-        if (!Is<Number>(obj_ptr)) {
-            throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
-        }
-        result *= As<Number>(obj_ptr)->GetValue();
-    });
-    return scope->CreateServiceObject<Number>(result);
+    std::shared_ptr<Scope> frame = std::make_shared<Scope>(scope.get());
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        frame->NameObject(CopyObject(values[i], frame), bindings[i].first->GetName());
+    }
+    return EvaluateSequence(body_ptr, frame);
 }
 
-Object* Division::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::optional<int64_t> result;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        obj_ptr = EvaluateObject(obj_ptr, scope);
-        if (!Is<Number>(obj_ptr)) {
-            throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
-        }
-        if (!result) {
-            result = As<Number>(obj_ptr)->GetValue();
-        } else {
-            *result /= As<Number>(obj_ptr)->GetValue();
-        }
-    });
-    if (!result) {
-        throw RuntimeError("No arguments for `/` operation");
+Object* LetStarStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // every expression sees the bindings before it, a single frame is enough for that
+    if (!cell_ptr) {
+        throw SyntaxError("Empty `let*`");
     }
+    auto bindings = ParseBindings(cell_ptr->GetFirst());
+    Cell* body_ptr = GetFormBody(cell_ptr, "let*");
 
-    return scope->CreateServiceObject<Number>(*result);
+    std::shared_ptr<Scope> frame = std::make_shared<Scope>(scope.get());
+    for (auto [symbol_ptr, expression] : bindings) {
+        frame->NameObject(CopyObject(EvaluateObject(expression, frame), frame),
+                          symbol_ptr->GetName());
+    }
+    return EvaluateSequence(body_ptr, frame);
 }
 
-Object* Minimum::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::optional<int64_t> result;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        obj_ptr = EvaluateObject(obj_ptr, scope);
-        if (!Is<Number>(obj_ptr)) {
-            throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
-        }
-        if (!result) {
-            result = As<Number>(obj_ptr)->GetValue();
-        } else {
-            result = std::min(*result, As<Number>(obj_ptr)->GetValue());
+Object* LetrecStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    if (!cell_ptr) {
+        throw SyntaxError("Empty `letrec`");
+    }
+    auto bindings = ParseBindings(cell_ptr->GetFirst());
+    Cell* body_ptr = GetFormBody(cell_ptr, "letrec");
+
+    // names are declared before evaluation, so that lambdas capture them instead of outer
+    // variables with the same names, captured placeholders are replaced afterwards
+    std::shared_ptr<Scope> frame = std::make_shared<Scope>(scope.get());
+    for (auto [symbol_ptr, expression] : bindings) {
+        frame->NameObject(nullptr, symbol_ptr->GetName());
+    }
+    std::vector<Object*> values;
+    for (auto [symbol_ptr, expression] : bindings) {
+        values.push_back(CopyObject(EvaluateObject(expression, frame), frame));
+    }
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        frame->NameObject(values[i], bindings[i].first->GetName());
+    }
+    for (Object* value : values) {
+        if (ScopedFunction* function_ptr = As<ScopedFunction>(value)) {
+            for (size_t i = 0; i < bindings.size(); ++i) {
+                function_ptr->Recapture(bindings[i].first->GetName(), values[i]);
+            }
         }
-    });
-    if (!result) {
-        throw RuntimeError("No arguments for `min` operation");
     }
+    return EvaluateSequence(body_ptr, frame);
+}
 
-    return scope->CreateServiceObject<Number>(*result);
+bool IsElseClause(Cell* clause_ptr) {
+    return Is<Symbol>(clause_ptr->GetFirst()) &&
+           As<Symbol>(clause_ptr->GetFirst())->GetName() == "else";
 }
 
-Object* Maximum::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::optional<int64_t> result;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        obj_ptr = EvaluateObject(obj_ptr, scope);
-        if (!Is<Number>(obj_ptr)) {
-            throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
+Object* CondStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(cond (test expression ...) (test => function) ... (else expression ...))`
+    for (; cell_ptr; cell_ptr = As<Cell>(cell_ptr->GetSecond())) {
+        Cell* clause_ptr = As<Cell>(cell_ptr->GetFirst());
+        if (!clause_ptr) {
+            throw SyntaxError("`cond` clause must be a list, but it is: `" +
+                              GetRepr(cell_ptr->GetFirst()) + "`");
         }
-        if (!result) {
-            result = As<Number>(obj_ptr)->GetValue();
-        } else {
-            result = std::max(*result, As<Number>(obj_ptr)->GetValue());
+
+        if (IsElseClause(clause_ptr)) {
+            if (cell_ptr->GetSecond()) {
+                throw SyntaxError("`else` must be the last clause of `cond`");
+            }
+            return EvaluateSequence(As<Cell>(clause_ptr->GetSecond()), scope);
         }
-    });
-    if (!result) {
-        throw RuntimeError("No arguments for `max` operation");
-    }
 
-    return scope->CreateServiceObject<Number>(*result);
-}
+        Object* test = EvaluateObject(clause_ptr->GetFirst(), scope);
+        if (IsFalse(test)) {
+            continue;
+        }
 
-Object* AbsoluteValue::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
-    if (!Is<Number>(obj_ptr)) {
-        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a number");
+        Cell* body_ptr = As<Cell>(clause_ptr->GetSecond());
+        if (!body_ptr) {
+            return test;
+        }
+        Symbol* arrow_ptr = As<Symbol>(body_ptr->GetFirst());
+        if (arrow_ptr && arrow_ptr->GetName() == "=>") {
+            Cell* receiver_ptr = As<Cell>(body_ptr->GetSecond());
+            if (!receiver_ptr || receiver_ptr->GetSecond()) {
+                throw SyntaxError("`=>` must be followed by exactly one function");
+            }
+            Function* function_ptr = GetFunction(EvaluateObject(receiver_ptr->GetFirst(), scope));
+            return function_ptr->Apply({test}, scope);
+        }
+        return EvaluateSequence(body_ptr, scope);
     }
-    return scope->CreateServiceObject<Number>(abs(As<Number>(obj_ptr)->GetValue()));
+    return nullptr;
 }
 
-Object* IsPair::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
-    if (obj_ptr && !Is<Cell>(obj_ptr)) {
-        return scope->CreateServiceObject<Boolean>(false);
+const CaseStatement::JumpTable& CaseStatement::GetJumpTable(Cell* cell_ptr) {
+    thread_local JumpTables jump_tables;
+    uint64_t epoch = garbage_collector::Instance().Epoch();
+    if (epoch != jump_tables.epoch) {
+        // forms of the previous epoch may be freed and their addresses reused
+        jump_tables.tables.clear();
+        jump_tables.epoch = epoch;
     }
-    auto objects = ListToVector(As<Cell>(obj_ptr));
-    return scope->CreateServiceObject<Boolean>(objects.size() == 2);
-}
 
-Object* IsNull::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
-    if (obj_ptr && !Is<Cell>(obj_ptr)) {
-        return scope->CreateServiceObject<Boolean>(false);
+    auto [it, inserted] = jump_tables.tables.try_emplace(cell_ptr);
+    if (!inserted) {
+        return it->second;
     }
-    auto objects = ListToVector(As<Cell>(obj_ptr));
-    return scope->CreateServiceObject<Boolean>(objects.size() == 0);
-}
 
-bool CheckProperList(Cell* cell_ptr) {
-    while (cell_ptr) {
-        if (Is<Cell>(cell_ptr->GetSecond())) {
-            cell_ptr = As<Cell>(cell_ptr->GetSecond());
-        } else {
-            if (cell_ptr->GetSecond()) {
-                return false;
-            } else {
-                return true;
+    JumpTable& table = it->second;
+    try {
+        for (Cell* clauses = As<Cell>(cell_ptr->GetSecond()); clauses;
+             clauses = As<Cell>(clauses->GetSecond())) {
+            Cell* clause_ptr = As<Cell>(clauses->GetFirst());
+            if (!clause_ptr) {
+                throw SyntaxError("`case` clause must be a list, but it is: `" +
+                                  GetRepr(clauses->GetFirst()) + "`");
+            }
+            if (IsElseClause(clause_ptr)) {
+                if (clauses->GetSecond()) {
+                    throw SyntaxError("`else` must be the last clause of `case`");
+                }
+                table.else_clause = clause_ptr;
+                break;
+            }
+            if (clause_ptr->GetFirst() && !Is<Cell>(clause_ptr->GetFirst())) {
+                throw SyntaxError("`case` clause must start with a list of data");
             }
+            ApplyToList(As<Cell>(clause_ptr->GetFirst()), [&](Object* datum) {
+                if (!table.clauses.Contains(datum)) {  // the first clause wins
+                    table.clauses.Insert(datum, clause_ptr);
+                }
+            });
         }
+    } catch (...) {
+        jump_tables.tables.erase(it);
+        throw;
     }
-    return true;
+    return table;
 }
 
-Object* IsList::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
-    if (obj_ptr && !Is<Cell>(obj_ptr)) {
-        return scope->CreateServiceObject<Boolean>(false);
+Object* CaseStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(case key ((datum ...) expression ...) ... (else expression ...))`, data are not evaluated
+    if (!cell_ptr) {
+        throw SyntaxError("Empty `case`");
     }
-    return scope->CreateServiceObject<Boolean>(CheckProperList(As<Cell>(obj_ptr)));
+    // the key is evaluated first: it may run tasks of other heaps on this thread, which clear
+    // the cache of jump tables, so the table is not held across the evaluation
+    Object* key = EvaluateObject(cell_ptr->GetFirst(), scope);
+    const JumpTable& table = GetJumpTable(cell_ptr);
+
+    Cell* clause_ptr = As<Cell>(table.clauses.Find(key));
+    if (!clause_ptr) {
+        clause_ptr = table.else_clause;
+    }
+    return clause_ptr ? EvaluateSequence(As<Cell>(clause_ptr->GetSecond()), scope) : nullptr;
 }
 
-Object* ConsOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::vector<Object*> evaluated_objects;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
-    });
-    return VectorToImproperList(evaluated_objects, scope);
+Object* WhenStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    if (!cell_ptr) {
+        throw SyntaxError("Empty `when`");
+    }
+    if (IsFalse(EvaluateObject(cell_ptr->GetFirst(), scope))) {
+        return nullptr;
+    }
+    return EvaluateSequence(As<Cell>(cell_ptr->GetSecond()), scope);
 }
 
-Object* CarOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    Object* evaluated_obj = EvaluateObject(cell_ptr->GetFirst(), scope);
-    if (!Is<Cell>(evaluated_obj)) {
-        throw RuntimeError("`car` argument should be pair, not: `" + GetRepr(evaluated_obj) + "`");
+Object* UnlessStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    if (!cell_ptr) {
+        throw SyntaxError("Empty `unless`");
     }
-    return As<Cell>(evaluated_obj)->GetFirst();
+    if (!IsFalse(EvaluateObject(cell_ptr->GetFirst(), scope))) {
+        return nullptr;
+    }
+    return EvaluateSequence(As<Cell>(cell_ptr->GetSecond()), scope);
 }
 
-Object* CdrOperation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    Object* evaluated_obj = EvaluateObject(cell_ptr->GetFirst(), scope);
-    if (!Is<Cell>(evaluated_obj)) {
-        throw RuntimeError("`cdr` argument should be pair, not: `" + GetRepr(evaluated_obj) + "`");
+bool HasOnlyTailCalls(Object* expression, const std::string& name, bool is_tail) {
+    if (Symbol* symbol_ptr = As<Symbol>(expression)) {
+        return symbol_ptr->GetName() != name;  // the name is used as a value
     }
-    return As<Cell>(evaluated_obj)->GetSecond();
+    Cell* cell_ptr = As<Cell>(expression);
+    if (!cell_ptr) {
+        return true;
+    }
+
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    // checks objects starting from `from`, the last of them is in the tail position of the form
+    auto check_sequence = [&](size_t from, bool tail_last) {
+        for (size_t i = from; i < objects.size(); ++i) {
+            if (!HasOnlyTailCalls(objects[i], name, tail_last && i + 1 == objects.size())) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Symbol* head_ptr = As<Symbol>(objects[0]);
+    std::string head = head_ptr ? head_ptr->GetName() : "";
+    if (head == "quote") {
+        return true;
+    } else if (head == name) {
+        return is_tail && check_sequence(1, false);
+    } else if (head == "if") {
+        // both branches are in tail position
+        return objects.size() > 1 && HasOnlyTailCalls(objects[1], name, false) &&
+               std::all_of(objects.begin() + 2, objects.end(), [&](Object* obj_ptr) {
+                   return HasOnlyTailCalls(obj_ptr, name, is_tail);
+               });
+    } else if (head == "begin" || head == "and" || head == "or") {
+        return check_sequence(1, is_tail);
+    } else if (head == "when" || head == "unless") {
+        return objects.size() > 1 && HasOnlyTailCalls(objects[1], name, false) &&
+               check_sequence(2, is_tail);
+    } else if (head == "let" || head == "let*" || head == "letrec") {
+        // binding names are checked too, shadowing the loop name falls back to recursion
+        size_t bindings = objects.size() > 1 && Is<Symbol>(objects[1]) ? 2 : 1;
+        return objects.size() > bindings && HasOnlyTailCalls(objects[1], name, false) &&
+               HasOnlyTailCalls(objects[bindings], name, false) &&
+               check_sequence(bindings + 1, is_tail);
+    } else if (head == "cond" || head == "case") {
+        size_t clauses = 1;
+        if (head == "case") {
+            if (objects.size() < 2 || !HasOnlyTailCalls(objects[1], name, false)) {
+                return false;
+            }
+            clauses = 2;
+        }
+        for (size_t i = clauses; i < objects.size(); ++i) {
+            std::vector<Object*> clause = ListToVector(As<Cell>(objects[i]));
+            bool has_arrow = std::any_of(clause.begin(), clause.end(), [](Object* obj_ptr) {
+                return Is<Symbol>(obj_ptr) && As<Symbol>(obj_ptr)->GetName() == "=>";
+            });
+            for (size_t j = 0; j < clause.size(); ++j) {
+                if (head == "case" && j == 0) {
+                    continue;  // data are not evaluated
+                }
+                bool tail = is_tail && !has_arrow && j > 0 && j + 1 == clause.size();
+                if (!HasOnlyTailCalls(clause[j], name, tail)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    return check_sequence(0, false);
 }
 
-Object* ListMaker::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::vector<Object*> evaluated_objects;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
-    });
-    return VectorToProperList(evaluated_objects, scope);
+Object* LoopContinuation::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    arguments_.clear();
+    ApplyToList(cell_ptr,
+                [&](Object* obj_ptr) { arguments_.push_back(EvaluateObject(obj_ptr, scope)); });
+    return this;
 }
 
-Object* ListRef::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::vector<Object*> evaluated_objects;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
-    });
-    if (!Is<Number>(evaluated_objects[1])) {
-        throw RuntimeError("Second argument must be a number, but it is: `" +
-                           GetRepr(evaluated_objects[1]) + "`");
-    }
-    if (evaluated_objects[0] && !Is<Cell>(evaluated_objects[0])) {
-        throw RuntimeError("First argument must be a list, but it is: `" +
-                           GetRepr(evaluated_objects[0]) + "`");
+Object* EvaluateNamedLet(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(let name ((variable init) ...) body ...)`
+    const std::string& name = As<Symbol>(cell_ptr->GetFirst())->GetName();
+    Cell* rest_ptr = As<Cell>(cell_ptr->GetSecond());
+    if (!rest_ptr) {
+        throw SyntaxError("Named `let` has no bindings");
     }
-    int64_t index = As<Number>(evaluated_objects[1])->GetValue();
-    auto objects = ListToVector(As<Cell>(evaluated_objects[0]));
-    if (index < 0 || index >= objects.size()) {
-        throw RuntimeError("Index is out of range: `" + GetRepr(evaluated_objects[1]) +
-                           "`, size: `" + std::to_string(objects.size()) + "`");
+    auto bindings = ParseBindings(rest_ptr->GetFirst());
+    Cell* body_ptr = GetFormBody(rest_ptr, "let");
+
+    std::vector<Object*> values;
+    for (auto [symbol_ptr, expression] : bindings) {
+        values.push_back(EvaluateObject(expression, scope));
     }
-    return objects[index];
-}
 
-Cell* FindKthNodeInList(Cell* cell_ptr, size_t k) {
-    // assumming that the list has at least k elements
-    // TODO: can be done with apply
-    while (cell_ptr && k) {
-        if (!As<Cell>(cell_ptr->GetSecond())) {
-            throw RuntimeError("List must be proper!");
+    std::shared_ptr<Scope> frame = std::make_shared<Scope>(scope.get());
+    bool is_flat_loop = true;
+    for (Cell* it = body_ptr; it; it = As<Cell>(it->GetSecond())) {
+        if (!HasOnlyTailCalls(it->GetFirst(), name, !it->GetSecond())) {
+            is_flat_loop = false;
+            break;
         }
-        --k;
-        cell_ptr = As<Cell>(cell_ptr->GetSecond());
     }
-    return cell_ptr;
-}
 
-Object* ListTail::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    std::vector<Object*> evaluated_objects;
-    ApplyToList(cell_ptr, [&](Object* obj_ptr) {
-        evaluated_objects.push_back(EvaluateObject(obj_ptr, scope));
-    });
-    if (!Is<Number>(evaluated_objects[1])) {
-        throw RuntimeError("Second argument must be a number, but it is: `" +
-                           GetRepr(evaluated_objects[1]) + "`");
-    }
-    if (evaluated_objects[0] && !Is<Cell>(evaluated_objects[0])) {
-        throw RuntimeError("First argument must be a list, but it is: `" +
-                           GetRepr(evaluated_objects[0]) + "`");
+    if (!is_flat_loop) {
+        // the name escapes or is called in a non-tail position, so it becomes a real recursive
+        // function, which captures itself like in `letrec`
+        std::vector<Object*> argnames;
+        for (auto [symbol_ptr, expression] : bindings) {
+            argnames.push_back(symbol_ptr);
+        }
+        frame->NameObject(nullptr, name);
+        Function* function_ptr =
+            As<Function>(CreateLambda(argnames, ListToVector(body_ptr), frame));
+        As<ScopedFunction>(function_ptr)->Recapture(name, function_ptr);
+        frame->NameObject(function_ptr, name);
+        return function_ptr->Apply(values, frame);
     }
-    int64_t index = As<Number>(evaluated_objects[1])->GetValue();
-    auto objects = ListToVector(As<Cell>(evaluated_objects[0]));
-    if (index < 0 || index > objects.size()) {
-        throw RuntimeError("Index is out of range: `" + GetRepr(evaluated_objects[1]) +
-                           "`, size: `" + std::to_string(objects.size()) + "`");
+
+    // the loop variables live in one frame and are rebound in place on every iteration, initial
+    // values are copied like in `let`, later ones are not: a copy of an accumulated list on
+    // every iteration would make the loop quadratic
+    LoopContinuation* continuation_ptr =
+        frame->CreateServiceObject<LoopContinuation>(bindings.size());
+    frame->NameObject(continuation_ptr, name);
+    for (Object*& value : values) {
+        value = CopyObject(value, frame);
     }
-    if (index == objects.size()) {
-        return nullptr;
+    while (true) {
+        for (size_t i = 0; i < bindings.size(); ++i) {
+            frame->NameObject(values[i], bindings[i].first->GetName());
+        }
+        Object* result = EvaluateSequence(body_ptr, frame);
+        if (result != continuation_ptr) {
+            return result;
+        }
+        values = continuation_ptr->GetArguments();
     }
-    return FindKthNodeInList(As<Cell>(evaluated_objects[0]), index);
 }
 
-Object* IfStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
-    // arguments quantity control is on InvokeImpl now, because we want to throw SyntaxError
-    // instead of RuntimeError in this function
+Object* DoStatement::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    // `(do ((variable init step) ...) (test result ...) body ...)`, steps are assigned
+    // simultaneously after every iteration
     std::vector<Object*> objects = ListToVector(cell_ptr);
-    if (objects.size() < 2 || objects.size() > 3) {
-        throw SyntaxError("Incorrect number of parameters for if statement");
+    if (objects.size() < 2 || (objects[0] && !Is<Cell>(objects[0])) || !Is<Cell>(objects[1])) {
+        throw SyntaxError("`do` expects variables and a termination clause");
     }
 
-    Object* statement = EvaluateObject(objects[0], scope);
-    if (!IsBooleanConstant(statement)) {
-        throw RuntimeError("Statement value should be bool");
+    std::vector<std::string> names;
+    std::vector<Object*> steps;  // nullptr if the variable has no step
+    std::vector<Object*> values;
+    ApplyToList(As<Cell>(objects[0]), [&](Object* obj_ptr) {
+        std::vector<Object*> spec = Is<Cell>(obj_ptr) ? ListToVector(As<Cell>(obj_ptr))
+                                                       : std::vector<Object*>{};
+        if (spec.size() < 2 || spec.size() > 3 || !Is<Symbol>(spec[0])) {
+            throw SyntaxError("`do` variable must be a name, an initial value and optional step, "
+                              "but it is: `" +
+                              GetRepr(obj_ptr) + "`");
+        }
+        names.push_back(As<Symbol>(spec[0])->GetName());
+        values.push_back(EvaluateObject(spec[1], scope));
+        steps.push_back(spec.size() == 3 ? spec[2] : nullptr);
+    });
+
+    Cell* exit_ptr = As<Cell>(objects[1]);
+    std::shared_ptr<Scope> frame = std::make_shared<Scope>(scope.get());
+    for (size_t i = 0; i < names.size(); ++i) {
+        frame->NameObject(CopyObject(values[i], frame), names[i]);
     }
 
-    if (GetRepr(statement) == "#t") {
-        return EvaluateObject(objects[1], scope);
-    } else {
-        return (objects.size() == 3) ? EvaluateObject(objects[2], scope) : nullptr;
+    while (IsFalse(EvaluateObject(exit_ptr->GetFirst(), frame))) {
+        for (size_t i = 2; i < objects.size(); ++i) {
+            EvaluateObject(objects[i], frame);
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (steps[i]) {
+                values[i] = EvaluateObject(steps[i], frame);
+            }
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (steps[i]) {
+                frame->NameObject(values[i], names[i]);  // not copied, as in a named `let`
+            }
+        }
     }
+    return EvaluateSequence(As<Cell>(exit_ptr->GetSecond()), frame);
 }
 
 Object* CreateLambda(const std::vector<Object*>& arguments, const std::vector<Object*>& commands,
@@ -470,6 +1633,129 @@ Object* Definition::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
     return nullptr;
 }
 
+Object* DefineMemoized::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.empty() || !Is<Cell>(objects[0])) {
+        throw SyntaxError("Memoized definition must start with function name and arguments");
+    }
+
+    Function* function_ptr = As<Function>(DefineFunction(objects, scope));
+    const std::string& name = As<Symbol>(As<Cell>(objects[0])->GetFirst())->GetName();
+    scope->NameObject(
+        scope->CreateServiceObject<MemoizedFunction>(function_ptr, std::make_shared<MemoCache>()),
+        name);
+    return nullptr;
+}
+
+Object* Memoize::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.empty() || objects.size() > 2) {
+        throw RuntimeError("`memoize` expects function and optional capacity");
+    }
+
+    Object* function_ptr = EvaluateObject(objects[0], scope);
+    if (!Is<Function>(function_ptr)) {
+        throw RuntimeError("Cannot memoize `" + GetRepr(function_ptr) + "`");
+    }
+
+    size_t capacity = MemoCache::kDefaultCapacity;
+    if (objects.size() == 2) {
+        Object* capacity_ptr = EvaluateObject(objects[1], scope);
+        if (!Is<Number>(capacity_ptr) || As<Number>(capacity_ptr)->GetValue() <= 0) {
+            throw RuntimeError("Capacity must be a positive number, but it is: `" +
+                               GetRepr(capacity_ptr) + "`");
+        }
+        capacity = As<Number>(capacity_ptr)->GetValue();
+    }
+
+    return scope->CreateServiceObject<MemoizedFunction>(As<Function>(function_ptr),
+                                                        std::make_shared<MemoCache>(capacity));
+}
+
+const MemoCache& GetMemoCache(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (!Is<MemoizedFunction>(obj_ptr)) {
+        throw RuntimeError("`" + GetRepr(obj_ptr) + "` is not a memoized function");
+    }
+    return As<MemoizedFunction>(obj_ptr)->GetCache();
+}
+
+Object* MemoizeHits::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return scope->CreateServiceObject<Number>(GetMemoCache(cell_ptr, scope).Hits());
+}
+
+Object* MemoizeMisses::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    return scope->CreateServiceObject<Number>(GetMemoCache(cell_ptr, scope).Misses());
+}
+
+Object* FutureFunction::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    auto state = std::make_shared<FutureState>(cell_ptr->GetFirst(), scope->Snapshot(),
+                                               &TaskScheduler::Shared());
+    // pending futures are roots, the snapshot stays alive even if the future itself is dropped
+    garbage_collector::Instance().AddRoot(state);
+    state->Start(state);
+    return scope->CreateServiceObject<Future>(state);
+}
+
+Object* TouchFunction::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+    if (!Is<Future>(obj_ptr)) {
+        throw RuntimeError("`touch` argument should be future, not: `" + GetRepr(obj_ptr) + "`");
+    }
+    return As<Future>(obj_ptr)->Touch();
+}
+
+Object* ParallelMap::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
+    constexpr size_t kChunksPerThread = 4;  // uneven chunks are evened out by stealing
+
+    std::vector<Object*> objects = ListToVector(cell_ptr);
+    if (objects.size() < 2) {
+        throw RuntimeError("`pmap` expects a function and at least one list");
+    }
+
+    Function* function_ptr = GetFunction(EvaluateObject(objects[0], scope));
+    std::vector<Cell*> lists = EvaluateLists(objects, 1, scope);
+    std::vector<std::vector<Object*>> rows(1);
+    while (NextListsRow(lists, &rows.back())) {
+        rows.emplace_back();
+    }
+    rows.pop_back();
+
+    TaskScheduler& scheduler = TaskScheduler::Shared();
+    size_t chunks_count = std::min(rows.size(), scheduler.ThreadsCount() * kChunksPerThread);
+    std::vector<Object*> results(rows.size());
+    std::vector<garbage_collector::GarbageCollector> heaps(chunks_count);
+    std::vector<std::exception_ptr> errors(chunks_count);
+    {
+        // the caller waits, so its scope does not change and is shared by the chunks
+        TaskGroup tasks(&scheduler);
+        for (size_t chunk = 0; chunk < chunks_count; ++chunk) {
+            tasks.Submit([&, chunk] {
+                garbage_collector::HeapBinding binding(&heaps[chunk]);
+                auto frame = std::make_shared<Scope>(scope.get());
+                try {
+                    for (size_t i = rows.size() * chunk / chunks_count;
+                         i < rows.size() * (chunk + 1) / chunks_count; ++i) {
+                        results[i] = function_ptr->Apply(rows[i], frame);
+                    }
+                } catch (...) {
+                    errors[chunk] = std::current_exception();
+                }
+            });
+        }
+    }
+
+    for (size_t chunk = 0; chunk < chunks_count; ++chunk) {
+        garbage_collector::Instance().Merge(heaps[chunk]);
+    }
+    for (std::exception_ptr& error : errors) {  // the first one in the order of the list
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return VectorToProperList(results, scope);
+}
+
 Object* MakeLambda::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
     std::vector<Object*> objects = ListToVector(cell_ptr);
     if (objects.empty() || (objects[0] && !Is<Cell>(objects[0]))) {
@@ -499,12 +1785,15 @@ Object* SetVariable::InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
         throw SyntaxError("Name of variable is not a symbol");
     }
 
-    if (!scope->GetObjectInAncestorScope(symbol_ptr->GetName())) {
+    // the variable is changed where it is defined, so that `set!` inside `let` or `cond` body is
+    // visible outside of it
+    Scope* defining_scope = scope->GetDefiningScope(symbol_ptr->GetName());
+    if (!defining_scope) {
         throw NameError("No such variable: `" + symbol_ptr->GetName() + "`");
     }
 
-    return scope->NameObject(CopyObject(EvaluateObject(objects[1], scope), scope),
-                             symbol_ptr->GetName());
+    return defining_scope->NameObject(CopyObject(EvaluateObject(objects[1], scope), scope),
+                                      symbol_ptr->GetName());
 }
 
 std::pair<Cell*, Object*> SetCarCdrBody(Cell* cell_ptr, std::shared_ptr<Scope> scope) {
@@ -1,7 +1,13 @@
 #pragma once
 
+#include "bytevector.h"
+#include "hash_table.h"
 #include "object.h"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <unordered_map>
 #include <vector>
 #include <unordered_set>
 
@@ -47,173 +53,827 @@ public:
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
+int64_t GetNumberValue(Object* obj_ptr);  // throws if object is not a number
+
+bool IsInteger(Object* obj_ptr);  // `Number` or `BigNumber`
+
+bool IsNumeric(Object* obj_ptr);  // any number, exact or inexact
+
+BigInteger GetBigIntegerValue(Object* obj_ptr);  // throws if object is not an integer
+
+double GetFlonumValue(Object* obj_ptr);  // converts exact numbers, throws if not a number
+
 template <class Predicate>
 Object* CheckOrderList(Cell* cell_ptr, std::shared_ptr<Scope> scope, Predicate&& pred) {
-    auto objects = ListToVector(cell_ptr);
-    Boolean* ans_ptr = scope->CreateServiceObject<Boolean>(true);
     Object* prev_obj = nullptr;
-    for (size_t i = 1; i < objects.size(); ++i) {
-        if (i == 1) {
-            prev_obj = EvaluateObject(objects[i - 1], scope);
-        }
-        Object* current_obj = EvaluateObject(objects[i], scope);
-        if (!pred(prev_obj, current_obj)) {
-            ans_ptr->Set(false);
-            break;
+    while (cell_ptr) {
+        Object* current_obj = EvaluateObject(cell_ptr->GetFirst(), scope);
+        if (prev_obj && !pred(prev_obj, current_obj)) {
+            return GetBooleanConstant(false);
         }
         prev_obj = current_obj;
+        cell_ptr = As<Cell>(cell_ptr->GetSecond());
+    }
+    return GetBooleanConstant(true);
+}
+
+template <class Comparison>
+bool CompareNumbers(Object* lhs, Object* rhs) {
+    Number* lhs_number = As<Number>(lhs);
+    Number* rhs_number = As<Number>(rhs);
+    if (lhs_number && rhs_number) {
+        return Comparison{}(lhs_number->GetValue(), rhs_number->GetValue());
+    }
+    if (!IsNumeric(lhs) || !IsNumeric(rhs)) {
+        throw RuntimeError("Cannot compare: `" + GetRepr(lhs) + "` and `" + GetRepr(rhs) + "`");
     }
-    return ans_ptr;
+    if (Is<Flonum>(lhs) || Is<Flonum>(rhs)) {
+        return Comparison{}(GetFlonumValue(lhs), GetFlonumValue(rhs));
+    }
+    return Comparison{}(GetBigIntegerValue(lhs), GetBigIntegerValue(rhs));
 }
 
-class Equal final : public StandartFunction {
+template <class Comparison>
+class NumericOrder final : public BinaryFunction {  // `=`, `<`, `>`, `<=` and `>=`
 public:
-    Equal(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    NumericOrder(std::optional<size_t> args_count = std::nullopt) : BinaryFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override {
+        return CheckOrderList(cell_ptr, scope, CompareNumbers<Comparison>);
+    }
+
+    Object* InvokeBinary(Object* lhs, Object* rhs, std::shared_ptr<Scope>) override {
+        return GetBooleanConstant(CompareNumbers<Comparison>(lhs, rhs));
+    }
+};
+
+using Equal = NumericOrder<std::equal_to<>>;
+using Less = NumericOrder<std::less<>>;
+using Greater = NumericOrder<std::greater<>>;
+using LessEqual = NumericOrder<std::less_equal<>>;
+using GreaterEqual = NumericOrder<std::greater_equal<>>;
+
+template <class Operation>
+class NumericFold final : public BinaryFunction {  // both variadic and binary forms of `Operation`
+public:
+    NumericFold(std::optional<size_t> args_count = std::nullopt) : BinaryFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override {
+        std::optional<int64_t> result = Operation::kIdentity;
+        std::optional<BigInteger> big_result;  // used since the first overflow
+        std::optional<double> float_result;    // used since the first inexact argument
+        ApplyToList(cell_ptr, [&](Object* obj_ptr) {
+            obj_ptr = EvaluateObject(obj_ptr, scope);
+            if (float_result) {
+                float_result = Operation::Apply(*float_result, GetFlonumValue(obj_ptr));
+                return;
+            }
+
+            if (Flonum* flonum_ptr = As<Flonum>(obj_ptr)) {
+                // inexact contagion, the value accumulated so far is converted once and the rest
+                // of the fold stays unboxed
+                double value = flonum_ptr->GetValue();
+                if (big_result) {
+                    float_result = Operation::Apply(big_result->ToDouble(), value);
+                } else if (result) {
+                    float_result = Operation::Apply(static_cast<double>(*result), value);
+                } else {
+                    float_result = value;
+                }
+                return;
+            }
+
+            if (big_result) {
+                big_result = Operation::Apply(*big_result, GetBigIntegerValue(obj_ptr));
+                return;
+            }
+
+            if (Number* number_ptr = As<Number>(obj_ptr)) {
+                int64_t next_result = number_ptr->GetValue();
+                if (!result || Operation::Apply(*result, next_result, &next_result)) {
+                    result = next_result;
+                    return;
+                }
+            }
+
+            // overflow or big argument, switching to arbitrary precision
+            BigInteger value = GetBigIntegerValue(obj_ptr);
+            big_result = result ? Operation::Apply(BigInteger(*result), value) : value;
+        });
+
+        if (float_result) {
+            return scope->CreateServiceObject<Flonum>(*float_result);
+        }
+        if (big_result) {
+            return CreateInteger(std::move(*big_result), scope);
+        }
+        if (!result) {
+            throw RuntimeError(std::string("No arguments for `") + Operation::kName +
+                               "` operation");
+        }
+        return CreateNumber(*result, scope);
+    }
+
+    Object* InvokeBinary(Object* lhs, Object* rhs, std::shared_ptr<Scope> scope) override {
+        Number* lhs_number = As<Number>(lhs);
+        Number* rhs_number = As<Number>(rhs);
+        int64_t result = 0;
+        if (lhs_number && rhs_number &&
+            Operation::Apply(lhs_number->GetValue(), rhs_number->GetValue(), &result)) {
+            return CreateNumber(result, scope);
+        }
+        if (Is<Flonum>(lhs) || Is<Flonum>(rhs)) {
+            return scope->CreateServiceObject<Flonum>(
+                Operation::Apply(GetFlonumValue(lhs), GetFlonumValue(rhs)));
+        }
+        return CreateInteger(Operation::Apply(GetBigIntegerValue(lhs), GetBigIntegerValue(rhs)),
+                             scope);
+    }
+};
+
+/*
+    Every operation has fixnum form, which returns false on overflow, arbitrary precision form and
+    floating point form
+*/
+
+struct AdditionOperation {
+    constexpr static inline const char* kName = "+";
+    constexpr static inline std::optional<int64_t> kIdentity = 0;
+
+    static bool Apply(int64_t lhs, int64_t rhs, int64_t* result) {
+        return !__builtin_add_overflow(lhs, rhs, result);
+    }
+
+    static BigInteger Apply(const BigInteger& lhs, const BigInteger& rhs) {
+        return lhs + rhs;
+    }
+
+    static double Apply(double lhs, double rhs) {
+        return lhs + rhs;
+    }
+};
+
+struct SubtractionOperation {
+    constexpr static inline const char* kName = "-";
+    constexpr static inline std::optional<int64_t> kIdentity = std::nullopt;
+
+    static bool Apply(int64_t lhs, int64_t rhs, int64_t* result) {
+        return !__builtin_sub_overflow(lhs, rhs, result);
+    }
+
+    static BigInteger Apply(const BigInteger& lhs, const BigInteger& rhs) {
+        return lhs - rhs;
+    }
+
+    static double Apply(double lhs, double rhs) {
+        return lhs - rhs;
+    }
+};
+
+struct MultiplicationOperation {
+    constexpr static inline const char* kName = "*";
+    constexpr static inline std::optional<int64_t> kIdentity = 1;
+
+    static bool Apply(int64_t lhs, int64_t rhs, int64_t* result) {
+        return !__builtin_mul_overflow(lhs, rhs, result);
+    }
+
+    static BigInteger Apply(const BigInteger& lhs, const BigInteger& rhs) {
+        return lhs * rhs;
+    }
+
+    static double Apply(double lhs, double rhs) {
+        return lhs * rhs;
+    }
+};
+
+struct DivisionOperation {
+    constexpr static inline const char* kName = "/";
+    constexpr static inline std::optional<int64_t> kIdentity = std::nullopt;
+
+    static bool Apply(int64_t lhs, int64_t rhs, int64_t* result) {
+        if (rhs == 0) {
+            throw RuntimeError("Division by zero");
+        }
+        if (lhs == std::numeric_limits<int64_t>::min() && rhs == -1) {
+            return false;
+        }
+        *result = lhs / rhs;
+        return true;
+    }
+
+    static BigInteger Apply(const BigInteger& lhs, const BigInteger& rhs) {
+        return lhs / rhs;
+    }
+
+    static double Apply(double lhs, double rhs) {
+        return lhs / rhs;
+    }
+};
+
+struct MinimumOperation {
+    constexpr static inline const char* kName = "min";
+    constexpr static inline std::optional<int64_t> kIdentity = std::nullopt;
+
+    static bool Apply(int64_t lhs, int64_t rhs, int64_t* result) {
+        *result = std::min(lhs, rhs);
+        return true;
+    }
+
+    static BigInteger Apply(const BigInteger& lhs, const BigInteger& rhs) {
+        return std::min(lhs, rhs);
+    }
+
+    static double Apply(double lhs, double rhs) {
+        return std::min(lhs, rhs);
+    }
+};
+
+struct MaximumOperation {
+    constexpr static inline const char* kName = "max";
+    constexpr static inline std::optional<int64_t> kIdentity = std::nullopt;
+
+    static bool Apply(int64_t lhs, int64_t rhs, int64_t* result) {
+        *result = std::max(lhs, rhs);
+        return true;
+    }
+
+    static BigInteger Apply(const BigInteger& lhs, const BigInteger& rhs) {
+        return std::max(lhs, rhs);
+    }
+
+    static double Apply(double lhs, double rhs) {
+        return std::max(lhs, rhs);
+    }
+};
+
+using Addition = NumericFold<AdditionOperation>;
+using Subtraction = NumericFold<SubtractionOperation>;
+using Multiplication = NumericFold<MultiplicationOperation>;
+using Division = NumericFold<DivisionOperation>;
+using Minimum = NumericFold<MinimumOperation>;
+using Maximum = NumericFold<MaximumOperation>;
+
+class AbsoluteValue final : public StandartFunction {
+public:
+    AbsoluteValue(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Less final : public StandartFunction {
+class ExactToInexact final : public StandartFunction {
 public:
-    Less(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    ExactToInexact(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Greater final : public StandartFunction {
+class InexactToExact final : public StandartFunction {
 public:
-    Greater(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    InexactToExact(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class LessEqual final : public StandartFunction {
+class IsPair final : public StandartFunction {
 public:
-    LessEqual(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    IsPair(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class GreaterEqual final : public StandartFunction {
+class IsNull final : public StandartFunction {
 public:
-    GreaterEqual(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    IsNull(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Addition final : public StandartFunction {
+bool CheckProperList(Cell* cell_ptr);
+
+class IsList final : public StandartFunction {  // returns true if proper list
 public:
-    Addition(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    IsList(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class ConsOperation final : public StandartFunction {  // returns true if proper list
+public:
+    ConsOperation(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class CarOperation final : public StandartFunction {  // returns true if proper list
+public:
+    CarOperation(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Subtraction final : public StandartFunction {
+class CdrOperation final : public StandartFunction {  // returns true if proper list
 public:
-    Subtraction(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    CdrOperation(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Multiplication final : public StandartFunction {
+class ListMaker final : public StandartFunction {  // returns true if proper list
 public:
-    Multiplication(std::optional<size_t> args_count = std::nullopt)
+    ListMaker(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+Object* FindKthTailInList(Object* list_ptr, Object* index_ptr);
+/*
+    Walks only `k` cells, throws if the list is shorter. The tail may be the empty list
+*/
+
+class ListRef final : public StandartFunction {
+public:
+    ListRef(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class ListTail final : public StandartFunction {
+public:
+    ListTail(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+Cell* GetListCell(Object* obj_ptr);  // nullptr for the empty list, throws if object is not a pair
+
+Function* GetFunction(Object* obj_ptr);  // throws if object is not a function
+
+bool IsFalse(Object* obj_ptr);  // only `#f` is false
+
+class LengthOperation final : public StandartFunction {
+public:
+    LengthOperation(std::optional<size_t> args_count = std::nullopt)
         : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Division final : public StandartFunction {
+class AppendOperation final : public StandartFunction {
 public:
-    Division(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    AppendOperation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Minimum final : public StandartFunction {
+class ReverseOperation final : public StandartFunction {
 public:
-    Minimum(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    ReverseOperation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class Maximum final : public StandartFunction {
+class MapOperation final : public StandartFunction {
 public:
-    Maximum(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    MapOperation(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class AbsoluteValue final : public StandartFunction {
+class FilterOperation final : public StandartFunction {
 public:
-    AbsoluteValue(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    FilterOperation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class IsPair final : public StandartFunction {
+class FoldLeftOperation final : public StandartFunction {
 public:
-    IsPair(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    FoldLeftOperation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class IsNull final : public StandartFunction {
+class FoldRightOperation final : public StandartFunction {
 public:
-    IsNull(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    FoldRightOperation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-bool CheckProperList(Cell* cell_ptr);
+class ForEachOperation final : public StandartFunction {
+public:
+    ForEachOperation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
-class IsList final : public StandartFunction {  // returns true if proper list
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+struct EqualEquivalence {
+    bool operator()(Object* lhs, Object* rhs) const {
+        return EqualObjects(lhs, rhs);
+    }
+};
+
+struct EqvEquivalence {
+    bool operator()(Object* lhs, Object* rhs) const {
+        return EqvObjects(lhs, rhs);
+    }
+};
+
+template <class Equivalence>
+class ListMember final : public StandartFunction {  // `member` and `memq`
 public:
-    IsList(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    ListMember(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override {
+        Object* obj_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+        Object* list_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+        for (Cell* it = GetListCell(list_ptr); it; it = GetListCell(it->GetSecond())) {
+            if (Equivalence{}(obj_ptr, it->GetFirst())) {
+                return it;
+            }
+        }
+        return GetBooleanConstant(false);
+    }
+};
+
+template <class Equivalence>
+class AssociationListSearch final : public StandartFunction {  // `assoc` and `assq`
+public:
+    AssociationListSearch(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override {
+        Object* key_ptr = EvaluateObject(cell_ptr->GetFirst(), scope);
+        Object* list_ptr = EvaluateObject(As<Cell>(cell_ptr->GetSecond())->GetFirst(), scope);
+        for (Cell* it = GetListCell(list_ptr); it; it = GetListCell(it->GetSecond())) {
+            Cell* pair_ptr = As<Cell>(it->GetFirst());
+            if (!pair_ptr) {
+                throw RuntimeError("Association list element must be a pair, but it is: `" +
+                                   GetRepr(it->GetFirst()) + "`");
+            }
+            if (Equivalence{}(key_ptr, pair_ptr->GetFirst())) {
+                return pair_ptr;
+            }
+        }
+        return GetBooleanConstant(false);
+    }
+};
+
+using MemberOperation = ListMember<EqualEquivalence>;
+using MemqOperation = ListMember<EqvEquivalence>;
+using AssocOperation = AssociationListSearch<EqualEquivalence>;
+using AssqOperation = AssociationListSearch<EqvEquivalence>;
+
+Vector* GetVector(Object* obj_ptr);  // throws if object is not a vector
+
+size_t GetIndex(Object* obj_ptr, size_t size);  // throws if index is out of range
+
+class IsVector final : public StandartFunction {
+public:
+    IsVector(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class ConsOperation final : public StandartFunction {  // returns true if proper list
+class MakeVector final : public StandartFunction {
 public:
-    ConsOperation(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    MakeVector(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class CarOperation final : public StandartFunction {  // returns true if proper list
+class VectorMaker final : public StandartFunction {
 public:
-    CarOperation(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    VectorMaker(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class CdrOperation final : public StandartFunction {  // returns true if proper list
+class VectorRef final : public StandartFunction {
 public:
-    CdrOperation(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    VectorRef(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class ListMaker final : public StandartFunction {  // returns true if proper list
+class VectorSet final : public StandartFunction {
 public:
-    ListMaker(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    VectorSet(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class VectorLength final : public StandartFunction {
+public:
+    VectorLength(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-Cell* FindKthNodeInList(Cell* cell_ptr, size_t k);
+class VectorToList final : public StandartFunction {
+public:
+    VectorToList(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
 
-class ListRef final : public StandartFunction {  // returns true if proper list
+class ListToVectorOperation final : public StandartFunction {
 public:
-    ListRef(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    ListToVectorOperation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-class ListTail final : public StandartFunction {  // returns true if proper list
+/*
+    Bulk numeric operations unbox vector elements into a contiguous array once and run SIMD
+    kernels over it, vectors of bignums or mixed with non-numbers go through generic arithmetic
+*/
+enum class VectorKind { SmallFixnums, Fixnums, Exact, Inexact };  // from the most specific
+
+VectorKind ClassifyVector(const std::vector<Object*>& elements);  // throws on non-numbers
+
+class VectorSum final : public StandartFunction {
 public:
-    ListTail(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+    VectorSum(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class VectorDot final : public StandartFunction {
+public:
+    VectorDot(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class VectorMin final : public StandartFunction {
+public:
+    VectorMin(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class VectorMax final : public StandartFunction {
+public:
+    VectorMax(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class VectorAdd final : public StandartFunction {
+public:
+    VectorAdd(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class VectorScale final : public StandartFunction {
+public:
+    VectorScale(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class VectorCountIf final : public StandartFunction {
+public:
+    VectorCountIf(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+Bytevector* GetBytevector(Object* obj_ptr);  // throws if object is not a bytevector
+
+uint8_t GetByteValue(Object* obj_ptr);  // throws if object is not a number in [0, 255]
+
+class IsBytevector final : public StandartFunction {
+public:
+    IsBytevector(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class MakeBytevector final : public StandartFunction {
+public:
+    MakeBytevector(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class BytevectorU8Ref final : public StandartFunction {
+public:
+    BytevectorU8Ref(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class BytevectorU8Set final : public StandartFunction {
+public:
+    BytevectorU8Set(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class BytevectorS64Ref final : public StandartFunction {
+public:
+    BytevectorS64Ref(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class BytevectorLength final : public StandartFunction {
+public:
+    BytevectorLength(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class MmapFile final : public StandartFunction {
+public:
+    MmapFile(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class CompileFileFunction final : public StandartFunction {  // (compile-file source output)
+public:
+    CompileFileFunction(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class ReadFunction final : public StandartFunction {  // first datum of a string or bytevector
+public:
+    ReadFunction(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+const std::string& GetStringValue(Object* obj_ptr);  // throws if object is not a string
+
+class IsString final : public StandartFunction {
+public:
+    IsString(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class StringLength final : public StandartFunction {
+public:
+    StringLength(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class StringRef final : public StandartFunction {
+public:
+    StringRef(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class Substring final : public StandartFunction {
+public:
+    Substring(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class StringAppend final : public StandartFunction {
+public:
+    StringAppend(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class StringEqual final : public StandartFunction {
+public:
+    StringEqual(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class MakeStringBuilder final : public StandartFunction {
+public:
+    MakeStringBuilder(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class StringBuilderAppend final : public StandartFunction {
+public:
+    StringBuilderAppend(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class StringBuilderToString final : public StandartFunction {
+public:
+    StringBuilderToString(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+HashTable* GetHashTable(Object* obj_ptr);  // throws if object is not a hash table
+
+class IsHashTable final : public StandartFunction {
+public:
+    IsHashTable(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class MakeHashTable final : public StandartFunction {
+public:
+    MakeHashTable(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableRef final : public StandartFunction {
+public:
+    HashTableRef(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableSet final : public StandartFunction {
+public:
+    HashTableSet(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableDelete final : public StandartFunction {
+public:
+    HashTableDelete(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableCount final : public StandartFunction {
+public:
+    HashTableCount(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableContains final : public StandartFunction {
+public:
+    HashTableContains(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableKeys final : public StandartFunction {
+public:
+    HashTableKeys(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableValues final : public StandartFunction {
+public:
+    HashTableValues(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableToAlist final : public StandartFunction {
+public:
+    HashTableToAlist(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class HashTableWalk final : public StandartFunction {
+public:
+    HashTableWalk(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
 
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
@@ -225,6 +885,126 @@ public:
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
+Object* EvaluateSequence(Cell* cell_ptr, std::shared_ptr<Scope> scope);  // value of the last one
+
+std::vector<std::pair<Symbol*, Object*>> ParseBindings(Object* bindings_ptr);
+/*
+    Checks `((name expression) ...)` syntax of `let`-like forms
+*/
+
+class BeginStatement final : public StandartFunction {
+public:
+    BeginStatement(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class LetStatement final : public StandartFunction {
+public:
+    LetStatement(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class LetStarStatement final : public StandartFunction {
+public:
+    LetStarStatement(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class LetrecStatement final : public StandartFunction {
+public:
+    LetrecStatement(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class CondStatement final : public StandartFunction {
+public:
+    CondStatement(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class WhenStatement final : public StandartFunction {
+public:
+    WhenStatement(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class UnlessStatement final : public StandartFunction {
+public:
+    UnlessStatement(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class CaseStatement final : public StandartFunction {
+public:
+    CaseStatement(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+
+private:
+    struct JumpTable {
+        HashTable clauses{HashTable::Equivalence::Eqv};  // from datum to its clause
+        Cell* else_clause = nullptr;
+    };
+
+    struct JumpTables {
+        /*
+            Tables are built once per `case` form and keyed by its address, which stays unique
+            until the next garbage collection. They are kept per thread, not in the builtin,
+            which is shared by interpreters on different threads
+        */
+        std::unordered_map<Cell*, JumpTable> tables;
+        uint64_t epoch = 0;
+    };
+
+    const JumpTable& GetJumpTable(Cell* cell_ptr);
+};
+
+bool HasOnlyTailCalls(Object* expression, const std::string& name, bool is_tail);
+/*
+    True if every reference to `name` inside `expression` is a call in tail position, which
+    means the value of such a call is returned unchanged by all enclosing forms
+*/
+
+class LoopContinuation final : public StandartFunction {
+    /*
+        Bound to the name of a named `let` running as a flat loop. A call stores the new values of
+        loop variables and returns the continuation itself, which the loop recognizes as a request
+        for the next iteration
+    */
+public:
+    LoopContinuation(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+
+    const std::vector<Object*>& GetArguments() const {
+        return arguments_;
+    }
+
+private:
+    std::vector<Object*> arguments_;
+};
+
+Object* EvaluateNamedLet(Cell* cell_ptr, std::shared_ptr<Scope> scope);
+
+class DoStatement final : public StandartFunction {
+public:
+    DoStatement(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
 class Definition final : public StandartFunction {  // returns true if proper list
 public:
     Definition(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
@@ -232,13 +1012,75 @@ public:
     Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
 };
 
-Object* CreateLambda(const std::vector<Object*>& arguments, std::vector<Cell*>& commands,
+Object* CreateLambda(const std::vector<Object*>& arguments, const std::vector<Object*>& commands,
                      std::shared_ptr<Scope> scope);
 
 Object* DefineFunction(std::vector<Object*>& objects, std::shared_ptr<Scope> scope);
 
 Object* DefineVariable(std::vector<Object*>& objects, std::shared_ptr<Scope> scope);
 
+class DefineMemoized final : public StandartFunction {
+public:
+    DefineMemoized(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class Memoize final : public StandartFunction {
+public:
+    Memoize(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class MemoizeHits final : public StandartFunction {
+public:
+    MemoizeHits(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class MemoizeMisses final : public StandartFunction {
+public:
+    MemoizeMisses(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class FutureFunction final : public StandartFunction {
+    /*
+        `(future expr)` starts evaluation of `expr` on the task scheduler and returns a future at
+        once. The expression sees variables as they are at this moment, its `set!` changes only
+        its own bindings. Changing shared data, like `set-car!` or `vector-set!`, is unsupported
+    */
+public:
+    FutureFunction(std::optional<size_t> args_count = std::nullopt)
+        : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class TouchFunction final : public StandartFunction {  // waits for the value of a future
+public:
+    TouchFunction(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
+class ParallelMap final : public StandartFunction {
+    /*
+        Same as `map`, but rows are split into chunks which are mapped by tasks of the scheduler,
+        so the function must be pure. Every chunk allocates into a heap of its own, those are
+        merged into the heap of the caller once every chunk is over
+    */
+public:
+    ParallelMap(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
+
+    Object* InvokeImpl(Cell* cell_ptr, std::shared_ptr<Scope> scope) override;
+};
+
 class SetVariable final : public StandartFunction {  // returns true if proper list
 public:
     SetVariable(std::optional<size_t> args_count = std::nullopt) : StandartFunction(args_count){};
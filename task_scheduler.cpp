@@ -0,0 +1,136 @@
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+thread_local TaskScheduler* current_scheduler = nullptr;  // of the worker running on this thread
+thread_local size_t current_queue = 0;
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(size_t threads_count) {
+    threads_count = std::max<size_t>(threads_count, 1);
+    for (size_t i = 0; i < threads_count; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < threads_count; ++i) {
+        workers_.emplace_back(&TaskScheduler::Work, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stop_ = true;
+    }
+    wake_up_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::Shared() {
+    static TaskScheduler scheduler(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return scheduler;
+}
+
+void TaskScheduler::Submit(Task task) {
+    size_t index = current_scheduler == this
+                       ? current_queue
+                       : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // a worker checks the counter under this mutex before it sleeps, so it cannot miss it
+        std::lock_guard lock(sleep_mutex_);
+        queued_.fetch_add(1);
+    }
+    wake_up_.notify_one();
+}
+
+bool TaskScheduler::RunPendingTask() {
+    std::optional<Task> task =
+        Take(current_scheduler == this ? current_queue : queues_.size());
+    if (!task) {
+        return false;
+    }
+    (*task)();
+    return true;
+}
+
+std::optional<TaskScheduler::Task> TaskScheduler::Take(size_t own_queue) {
+    if (!queued_.load()) {
+        return std::nullopt;
+    }
+    if (own_queue < queues_.size()) {
+        Queue& queue = *queues_[own_queue];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            Task task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            queued_.fetch_sub(1);
+            return task;
+        }
+    }
+    for (size_t i = 1; i <= queues_.size(); ++i) {
+        Queue& queue = *queues_[(own_queue + i) % queues_.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            Task task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            queued_.fetch_sub(1);
+            return task;
+        }
+    }
+    return std::nullopt;
+}
+
+void TaskScheduler::Work(size_t index) {
+    current_scheduler = this;
+    current_queue = index;
+    while (true) {
+        if (std::optional<Task> task = Take(index)) {
+            (*task)();
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex_);
+        wake_up_.wait(lock, [&] { return stop_ || queued_.load(); });
+        if (stop_) {
+            return;
+        }
+    }
+}
+
+void TaskGroup::Submit(TaskScheduler::Task task) {
+    {
+        std::lock_guard lock(mutex_);
+        ++pending_;
+    }
+    scheduler_->Submit([this, task = std::move(task)] {
+        task();
+        std::lock_guard lock(mutex_);
+        if (!--pending_) {
+            done_.notify_all();
+        }
+    });
+}
+
+bool TaskGroup::IsDone() {
+    std::lock_guard lock(mutex_);
+    return !pending_;
+}
+
+void TaskGroup::Wait() {
+    while (!IsDone()) {
+        if (!scheduler_->RunPendingTask()) {
+            // the remaining tasks are running on other threads
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [&] { return !pending_; });
+            return;
+        }
+    }
+}
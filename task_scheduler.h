@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+class TaskScheduler {
+    /*
+        Work-stealing pool: a worker takes its own tasks from the back of its deque and steals
+        from the front of the others, so tasks spawned by a task stay on its thread while the
+        other workers are busy. Threads which wait for tasks run queued ones meanwhile, so nested
+        waits do not deadlock
+    */
+public:
+    using Task = std::function<void()>;  // must not throw
+
+    explicit TaskScheduler(size_t threads_count);
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    ~TaskScheduler();
+
+    static TaskScheduler& Shared();
+    /*
+        Created by the first use with a worker per hardware thread but one, as the thread which
+        waits for the tasks runs them too. It keeps no interpreter state, every task brings its
+        own heap and scope
+    */
+
+    void Submit(Task task);
+
+    bool RunPendingTask();  // on the calling thread, false if nothing was queued
+
+    size_t ThreadsCount() const {  // workers and the waiting thread
+        return workers_.size() + 1;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::optional<Task> Take(size_t own_queue);  // own queue first, `queues_.size()` if none
+
+    void Work(size_t index);
+
+private:
+    std::vector<std::unique_ptr<Queue>> queues_;  // one per worker
+    std::atomic<size_t> queued_ = 0;
+    std::atomic<size_t> next_queue_ = 0;  // for tasks submitted by other threads
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_up_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
+
+class TaskGroup {  // waits for the tasks submitted through it
+public:
+    explicit TaskGroup(TaskScheduler* scheduler) : scheduler_(scheduler) {
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        Wait();
+    }
+
+    void Submit(TaskScheduler::Task task);
+
+    bool IsDone();
+
+    void Wait();  // may be called by several threads at once
+
+private:
+    TaskScheduler* scheduler_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    size_t pending_ = 0;
+};
@@ -1,133 +1,316 @@
 #include "tokenizer.h"
 #include "error.h"
+#include "scan_kernels.h"
 #include "tokens.h"
 
-StateMachine::StateMachine() {
-    current_node_ = node_arr_;
+#include <array>
+#include <cctype>
+#include <string>
 
-    auto check_symbol_start = [](char ch) {
-        return std::isalpha(ch) || ch == '*' || ch == '#' || ch == '<' || ch == '>' || ch == '=' ||
-               ch == '/';
-    };
+namespace {
+
+enum CharClass : uint8_t {
+    kWhitespace = 1,
+    kDigit = 2,
+    kSymbolStart = 4,
+    kSymbolMid = 8,
+};
 
-    auto check_symbol_mid = [](char ch) {
-        return std::isalnum(ch) || ch == '*' || ch == '#' || ch == '<' || ch == '>' || ch == '=' ||
-               ch == '?' || ch == '!' || ch == '-' || ch == '/';
+constexpr std::array<uint8_t, 256> BuildCharClasses() {
+    // the same sets as `std::isspace` and `std::isalnum` give in the "C" locale
+    std::array<uint8_t, 256> classes{};
+    for (char ch : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+        classes[static_cast<uint8_t>(ch)] |= kWhitespace;
+    }
+    for (int ch = '0'; ch <= '9'; ++ch) {
+        classes[ch] |= kDigit | kSymbolMid;
+    }
+    for (int ch = 'a'; ch <= 'z'; ++ch) {
+        classes[ch] |= kSymbolStart | kSymbolMid;
+        classes[ch - 'a' + 'A'] |= kSymbolStart | kSymbolMid;
+    }
+    for (char ch : {'*', '#', '<', '>', '=', '/'}) {
+        classes[static_cast<uint8_t>(ch)] |= kSymbolStart | kSymbolMid;
+    }
+    for (char ch : {'?', '!', '-'}) {
+        classes[static_cast<uint8_t>(ch)] |= kSymbolMid;
+    }
+    return classes;
+}
+
+constexpr std::array<uint8_t, 256> kCharClasses = BuildCharClasses();
+
+using TransitionTable = std::array<std::array<uint8_t, 256>, StateMachine::kStatesCount>;
+
+constexpr TransitionTable BuildTransitions() {
+    using T = StateMachine::Terminals;
+    TransitionTable table{};
+    for (auto& row : table) {
+        row.fill(StateMachine::kNoTransition);
+    }
+    auto set = [&table](T from, char ch, T to) {
+        table[static_cast<size_t>(from)][static_cast<uint8_t>(ch)] = static_cast<uint8_t>(to);
     };
 
     // simple token ('\'', ")", "(", ".") transitions
-    current_node_->next['('] = node_arr_ + int(Terminals::OpenParTerminal);
-    current_node_->next[')'] = node_arr_ + int(Terminals::CloseParTerminal);
-    current_node_->next['.'] = node_arr_ + int(Terminals::DotTerminal);
-    current_node_->next['\''] = node_arr_ + int(Terminals::QuoteTerminal);
-
-    node_arr_[int(Terminals::OpenParTerminal)].producer =
-        std::make_unique<OpenParenthesisProducer>();
-    node_arr_[int(Terminals::CloseParTerminal)].producer =
-        std::make_unique<CloseParenthesisProducer>();
-    node_arr_[int(Terminals::DotTerminal)].producer = std::make_unique<DotProducer>();
-    node_arr_[int(Terminals::QuoteTerminal)].producer = std::make_unique<QuoteProducer>();
+    set(T::Root, '(', T::OpenParTerminal);
+    set(T::Root, ')', T::CloseParTerminal);
+    set(T::Root, '.', T::DotTerminal);
+    set(T::Root, '\'', T::QuoteTerminal);
+    set(T::Root, '+', T::PlusTerminal);
+    set(T::Root, '-', T::MinusTerminal);
 
     // constant and symbolic tokens transitions
+    for (char digit = '0'; digit <= '9'; ++digit) {
+        set(T::Root, digit, T::ConstantTerminal);
+        set(T::PlusTerminal, digit, T::ConstantTerminal);
+        set(T::MinusTerminal, digit, T::ConstantTerminal);
+        set(T::ConstantTerminal, digit, T::ConstantTerminal);
+        set(T::DotTerminal, digit, T::FractionTerminal);
+        set(T::SignedDot, digit, T::FractionTerminal);
+        set(T::FractionTerminal, digit, T::FractionTerminal);
+        set(T::ExponentMark, digit, T::ExponentTerminal);
+        set(T::ExponentSign, digit, T::ExponentTerminal);
+        set(T::ExponentTerminal, digit, T::ExponentTerminal);
+    }
 
-    node_arr_[int(Terminals::PlusTerminal)].producer = std::make_unique<SymbolProducer>();
-    node_arr_[int(Terminals::MinusTerminal)].producer = std::make_unique<SymbolProducer>();
-    node_arr_[int(Terminals::SymbolTerminal)].producer = std::make_unique<SymbolProducer>();
-    node_arr_[int(Terminals::ConstantTerminal)].producer = std::make_unique<ConstantProducer>();
+    // floating point literals: `1.5`, `.5`, `-.5`, `1.`, `1e10`, `-2.5E-3`
+    set(T::ConstantTerminal, '.', T::FractionTerminal);
+    set(T::PlusTerminal, '.', T::SignedDot);
+    set(T::MinusTerminal, '.', T::SignedDot);
+    for (char exponent : {'e', 'E'}) {
+        set(T::ConstantTerminal, exponent, T::ExponentMark);
+        set(T::FractionTerminal, exponent, T::ExponentMark);
+    }
+    set(T::ExponentMark, '+', T::ExponentSign);
+    set(T::ExponentMark, '-', T::ExponentSign);
 
-    for (char digit = '0'; digit <= '9'; ++digit) {
-        node_arr_[int(Terminals::PlusTerminal)].next[digit] =
-            node_arr_ + int(Terminals::ConstantTerminal);
-        node_arr_[int(Terminals::MinusTerminal)].next[digit] =
-            node_arr_ + int(Terminals::ConstantTerminal);
-        node_arr_[int(Terminals::Root)].next[digit] = node_arr_ + int(Terminals::ConstantTerminal);
-        node_arr_[int(Terminals::ConstantTerminal)].next[digit] =
-            node_arr_ + int(Terminals::ConstantTerminal);
-    }
-
-    for (char symbol = char(33); symbol <= char(126); ++symbol) {
-        if (check_symbol_start(symbol)) {
-            node_arr_[int(Terminals::Root)].next[symbol] =
-                node_arr_ + int(Terminals::SymbolTerminal);
+    for (int code = 33; code <= 126; ++code) {
+        if (kCharClasses[code] & kSymbolStart) {
+            set(T::Root, static_cast<char>(code), T::SymbolTerminal);
         }
-        if (check_symbol_mid(symbol)) {
-            node_arr_[int(Terminals::SymbolTerminal)].next[symbol] =
-                node_arr_ + int(Terminals::SymbolTerminal);
+        if (kCharClasses[code] & kSymbolMid) {
+            set(T::SymbolTerminal, static_cast<char>(code), T::SymbolTerminal);
         }
     }
 
-    node_arr_[int(Terminals::Root)].next['+'] = node_arr_ + int(Terminals::PlusTerminal);
-    node_arr_[int(Terminals::Root)].next['-'] = node_arr_ + int(Terminals::MinusTerminal);
+    // string literals, everything but `"` and `\` stays inside of the string
+    for (int code = 0; code < 256; ++code) {
+        set(T::StringBody, static_cast<char>(code), T::StringBody);
+        set(T::StringEscape, static_cast<char>(code), T::StringBody);
+    }
+    set(T::Root, '"', T::StringBody);
+    set(T::StringBody, '\\', T::StringEscape);
+    set(T::StringBody, '"', T::StringTerminal);
+    return table;
 }
 
-bool StateMachine::Move(char ch) {
-    auto it = current_node_->next.find(ch);
-    if (it != current_node_->next.end()) {
-        current_node_ = it->second;
-        token_str_ += ch;
-        return false;
-    } else {
-        return true;
+constexpr TransitionTable kTransitions = BuildTransitions();
+
+constexpr std::array<std::optional<CharRun>, StateMachine::kStatesCount> BuildStateRuns() {
+    // states with a self-loop over a whole class of bytes, their tails are skipped in bulk
+    using T = StateMachine::Terminals;
+    std::array<std::optional<CharRun>, StateMachine::kStatesCount> runs{};
+    runs[static_cast<size_t>(T::SymbolTerminal)] = CharRun::SymbolChars;
+    runs[static_cast<size_t>(T::ConstantTerminal)] = CharRun::Digits;
+    runs[static_cast<size_t>(T::FractionTerminal)] = CharRun::Digits;
+    runs[static_cast<size_t>(T::ExponentTerminal)] = CharRun::Digits;
+    runs[static_cast<size_t>(T::StringBody)] = CharRun::StringChars;
+    return runs;
+}
+
+constexpr std::array<std::optional<CharRun>, StateMachine::kStatesCount> kStateRuns =
+    BuildStateRuns();
+
+constexpr std::array<bool, StateMachine::kStatesCount> BuildDeadEnds() {
+    // tokens in these states are complete even at the end of a chunk, like `(` or `)`
+    std::array<bool, StateMachine::kStatesCount> dead_ends{};
+    for (size_t state = 0; state < StateMachine::kStatesCount; ++state) {
+        dead_ends[state] = true;
+        for (uint8_t next : kTransitions[state]) {
+            dead_ends[state] = dead_ends[state] && next == StateMachine::kNoTransition;
+        }
     }
+    return dead_ends;
 }
 
-bool StateMachine::IsEmptyToken() const {
-    return token_str_.empty();
+constexpr std::array<bool, StateMachine::kStatesCount> kDeadEnds = BuildDeadEnds();
+
+}  // namespace
+
+StateMachine::StateMachine() {
+    auto producer = [this](Terminals state) -> std::unique_ptr<ITokenProducer>& {
+        return producers_[static_cast<size_t>(state)];
+    };
+    producer(Terminals::OpenParTerminal) = std::make_unique<OpenParenthesisProducer>();
+    producer(Terminals::CloseParTerminal) = std::make_unique<CloseParenthesisProducer>();
+    producer(Terminals::DotTerminal) = std::make_unique<DotProducer>();
+    producer(Terminals::QuoteTerminal) = std::make_unique<QuoteProducer>();
+    producer(Terminals::PlusTerminal) = std::make_unique<SymbolProducer>();
+    producer(Terminals::MinusTerminal) = std::make_unique<SymbolProducer>();
+    producer(Terminals::SymbolTerminal) = std::make_unique<SymbolProducer>();
+    producer(Terminals::ConstantTerminal) = std::make_unique<ConstantProducer>();
+    producer(Terminals::StringTerminal) = std::make_unique<StringProducer>();
+    producer(Terminals::FractionTerminal) = std::make_unique<FloatProducer>();
+    producer(Terminals::ExponentTerminal) = std::make_unique<FloatProducer>();
+}
+
+uint8_t StateMachine::Move(uint8_t state, char ch) {
+    return kTransitions[state][static_cast<uint8_t>(ch)];
 }
 
-Token StateMachine::Flush() {
-    if (IsEmptyToken()) {
+bool StateMachine::IsWhitespace(char ch) {
+    return kCharClasses[static_cast<uint8_t>(ch)] & kWhitespace;
+}
+
+Token StateMachine::Flush(uint8_t state, std::string_view token) const {
+    if (token.empty()) {
         throw SyntaxError("Cannot flush empty token");
-    } else {
-        auto res = (*(current_node_->producer))(token_str_);
-        token_str_ = "";
-        current_node_ = node_arr_;
-        return res;
+    } else if (!producers_[state]) {
+        throw SyntaxError("Incomplete token: `" + std::string(token) + "`");
+    }
+    return (*producers_[state])(token);
+}
+
+Tokenizer::Tokenizer(std::istream* in) {
+    char chunk[1 << 16];
+    while (in->read(chunk, sizeof(chunk)) || in->gcount() > 0) {
+        storage_.append(chunk, in->gcount());
     }
+    buffer_ = storage_;
+    Next();
 }
 
-Tokenizer::Tokenizer(std::istream* in) : input_(in) {
+Tokenizer::Tokenizer(std::string_view buffer) : buffer_(buffer) {
     Next();
 }
 
+Tokenizer::Tokenizer() : reached_end_(true), input_finished_(false) {
+}
+
+void Tokenizer::Reset(std::string_view buffer) {
+    // token producers of the DFA are kept, they are allocated once per tokenizer
+    storage_.clear();
+    buffer_ = buffer;
+    position_ = 0;
+    token_start_ = 0;
+    token_state_ = 0;
+    last_token_.reset();
+    token_error_.clear();
+    reached_end_ = false;
+    input_finished_ = true;
+    Next();
+}
+
+void Tokenizer::Feed(std::string_view chunk) {
+    if (input_finished_) {
+        throw RuntimeError("Cannot feed a tokenizer after the end of input");
+    }
+
+    // consumed bytes are dropped, so the buffer holds only the current token and the new chunk
+    size_t consumed = reached_end_ ? position_ : token_start_;
+    storage_.erase(0, consumed);
+    storage_.append(chunk);
+    buffer_ = storage_;
+    position_ -= consumed;
+    token_start_ -= consumed;
+
+    if (reached_end_) {
+        reached_end_ = false;
+        Next();
+    } else {
+        FlushToken();  // symbols of the current token point into the old buffer
+    }
+}
+
+void Tokenizer::FinishFeed() {
+    input_finished_ = true;
+    if (reached_end_) {
+        reached_end_ = false;
+        Next();
+    }
+}
+
 bool Tokenizer::IsEnd() {
     return reached_end_;
 }
 
+bool Tokenizer::IsFinished() const {
+    return input_finished_;
+}
+
 void Tokenizer::Next() {
     if (reached_end_) {
         return;
     }
 
-    while (input_->peek() != EOF) {
-        char ch = input_->peek();
-        if (std::isspace(ch)) {
-            if (!token_dfa_.IsEmptyToken()) {
-                last_token_ = token_dfa_.Flush();
-                break;
-            }
-        } else {
-            if (token_dfa_.Move(ch)) {
-                last_token_ = token_dfa_.Flush();
-                break;
-            }
+    const char* data = buffer_.data();
+    const size_t size = buffer_.size();
+    if (position_ < size && StateMachine::IsWhitespace(data[position_])) {
+        // tokens are mostly separated by a single space, the kernel pays off on indentation
+        ++position_;
+        if (position_ < size && StateMachine::IsWhitespace(data[position_])) {
+            position_ += SkipRun(data + position_, size - position_, CharRun::Whitespace);
         }
-        input_->ignore();
+    }
+    if (position_ == size) {
+        reached_end_ = true;
+        return;
     }
 
-    if (input_->peek() == EOF) {
-        if (!token_dfa_.IsEmptyToken()) {
-            last_token_ = token_dfa_.Flush();
-        } else {
-            reached_end_ = true;
+    // the longest prefix accepted by the DFA is the token, whitespace inside of string literals
+    // has transitions of its own
+    const size_t start = position_;
+    uint8_t state = static_cast<uint8_t>(StateMachine::Terminals::Root);
+    while (position_ < size) {
+        uint8_t next = kTransitions[state][static_cast<uint8_t>(data[position_])];
+        if (next == StateMachine::kNoTransition) {
+            break;
+        }
+        state = next;
+        ++position_;
+        // one byte is checked through the table first, most runs end right away
+        if (kStateRuns[state] && position_ < size &&
+            kTransitions[state][static_cast<uint8_t>(data[position_])] == state) {
+            ++position_;
+            position_ += SkipRun(data + position_, size - position_, *kStateRuns[state]);
         }
     }
+    if (position_ == start) {
+        // the byte starts no token, it is consumed so that reading goes on after the error
+        unsigned char ch = data[position_++];
+        last_token_.reset();
+        token_error_ = std::isprint(ch) ? "Unexpected character: `" + std::string(1, ch) + "`"
+                                        : "Unexpected character with code " + std::to_string(ch);
+        return;
+    }
+    if (position_ == size && !input_finished_ && !kDeadEnds[state]) {
+        position_ = start;  // the token may go on in the next chunk
+        reached_end_ = true;
+        return;
+    }
+
+    token_start_ = start;
+    token_state_ = state;
+    FlushToken();
 }
 
-Token Tokenizer::GetToken() {
+Token& Tokenizer::GetToken() {
     if (last_token_) {
         return *last_token_;
+    } else if (!token_error_.empty()) {
+        throw SyntaxError(token_error_);
     } else {
         throw SyntaxError("No token extracted");
     }
-}
\ No newline at end of file
+}
+
+void Tokenizer::FlushToken() {
+    try {
+        last_token_ = token_dfa_.Flush(
+            token_state_, buffer_.substr(token_start_, position_ - token_start_));
+    } catch (const SyntaxError& error) {
+        last_token_.reset();
+        token_error_ = error.what();
+    }
+}
@@ -2,12 +2,12 @@
 
 #include "tokens.h"
 
+#include <cstdint>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <optional>
-#include <set>
-#include <vector>
+#include <string>
+#include <string_view>
 
 class StateMachine {  // DFA for extracting tokens
 public:
@@ -20,48 +20,69 @@ public:
         PlusTerminal = 5,
         MinusTerminal = 6,
         SymbolTerminal = 7,
-        ConstantTerminal = 8
+        ConstantTerminal = 8,
+        FractionTerminal = 9,
+        ExponentMark = 10,  // `e` after mantissa, token is not finished yet
+        ExponentSign = 11,
+        ExponentTerminal = 12,
+        StringBody = 13,  // inside of string literal, whitespaces are part of the token
+        StringEscape = 14,
+        StringTerminal = 15,
+        SignedDot = 16  // `-.` or `+.`, a fraction must follow
     };
 
-    constexpr static inline size_t kStatesCount = 9;
+    constexpr static inline size_t kStatesCount = 17;
+    constexpr static inline uint8_t kNoTransition = 0xFF;
 
 public:
     StateMachine();
 
-    bool Move(char);
-    /*
-        Returns true if need to flush,
-    */
+    static uint8_t Move(uint8_t state, char ch);  // `kNoTransition` if the token is over
 
-    bool IsEmptyToken() const;
+    static bool IsWhitespace(char ch);
 
-    Token Flush();
+    Token Flush(uint8_t state, std::string_view token) const;  // throws if state is not final
 
 private:
-    struct Node {
-        std::map<char, Node*> next;
-        std::unique_ptr<ITokenProducer> producer;
-    };
-
-private:
-    std::string token_str_;
-    Node node_arr_[kStatesCount];
-    Node* current_node_ = nullptr;
+    std::unique_ptr<ITokenProducer> producers_[kStatesCount];
 };
 
-class Tokenizer {
+class Tokenizer {  // scans the whole input as one contiguous buffer
 public:
-    Tokenizer(std::istream* in);
+    Tokenizer(std::istream* in);  // reads the stream into a buffer owned by the tokenizer
+
+    Tokenizer(std::string_view buffer);  // the buffer is not copied and must outlive tokens
+
+    Tokenizer();  // streaming mode, input arrives in chunks through `Feed`
+
+    Tokenizer(const Tokenizer&) = delete;  // symbol tokens may point into the owned buffer
+    Tokenizer& operator=(const Tokenizer&) = delete;
 
-    bool IsEnd();
+    void Reset(std::string_view buffer);  // starts over on another buffer, like a new tokenizer
+
+    void Feed(std::string_view chunk);  // tokens may be split between chunks arbitrarily
+
+    void FinishFeed();  // no more chunks, the last token ends with the input
+
+    bool IsEnd();  // in streaming mode also while the next token may continue in the next chunk
+
+    bool IsFinished() const;  // no more chunks may come, `FinishFeed` was called or no stream
 
     void Next();
 
-    Token GetToken();
+    Token& GetToken();  // reference to the current token, throws if the token is malformed
 
 private:
+    void FlushToken();  // errors are kept for `GetToken`, so that `Next` can move past them
+
     StateMachine token_dfa_;
-    std::istream* input_;
+    std::string storage_;  // empty unless the input is a stream or comes in chunks
+    std::string_view buffer_;
+    size_t position_ = 0;
+    size_t token_start_ = 0;  // the current token is kept in the buffer until `Next`
+    uint8_t token_state_ = 0;
     std::optional<Token> last_token_;
+    std::string token_error_;
     bool reached_end_ = false;
-};
\ No newline at end of file
+    bool input_finished_ = true;
+};
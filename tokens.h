@@ -1,13 +1,17 @@
 #pragma once
 
+#include <bit>
+#include <charconv>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <string_view>
 #include <variant>
 
 struct SymbolToken {
-    std::string name;
+    std::string_view name;  // points into the tokenizer buffer, copied once the symbol is created
 
     bool operator==(const SymbolToken& other) const {
         return name == other.name;
@@ -36,20 +40,45 @@ struct ConstantToken {
     }
 };
 
-using Token = std::variant<ConstantToken, BracketToken, SymbolToken, QuoteToken, DotToken>;
+struct StringToken {
+    std::string value;  // without quotes, escape sequences are already replaced
+
+    bool operator==(const StringToken& other) const {
+        return value == other.value;
+    }
+};
+
+struct FloatConstantToken {
+    double value;
+
+    bool operator==(const FloatConstantToken& other) const {
+        return value == other.value;
+    }
+};
+
+struct BigConstantToken {  // integer literal which does not fit into `int64_t`
+    std::string digits;
+
+    bool operator==(const BigConstantToken& other) const {
+        return digits == other.digits;
+    }
+};
+
+using Token = std::variant<ConstantToken, BracketToken, SymbolToken, QuoteToken, DotToken,
+                           BigConstantToken, FloatConstantToken, StringToken>;
 
 class ITokenProducer {
 public:
     ITokenProducer() = default;
     virtual ~ITokenProducer() = default;
-    virtual Token operator()(const std::string&) const = 0;
+    virtual Token operator()(std::string_view) const = 0;
 };
 
 class OpenParenthesisProducer final : public ITokenProducer {
 public:
     OpenParenthesisProducer() = default;
 
-    Token operator()(const std::string&) const override {
+    Token operator()(std::string_view) const override {
         return BracketToken::OPEN;
     }
 };
@@ -58,7 +87,7 @@ class CloseParenthesisProducer final : public ITokenProducer {
 public:
     CloseParenthesisProducer() = default;
 
-    Token operator()(const std::string&) const override {
+    Token operator()(std::string_view) const override {
         return BracketToken::CLOSE;
     }
 };
@@ -67,7 +96,7 @@ class DotProducer final : public ITokenProducer {
 public:
     DotProducer() = default;
 
-    Token operator()(const std::string&) const override {
+    Token operator()(std::string_view) const override {
         return DotToken{};
     }
 };
@@ -76,17 +105,101 @@ class QuoteProducer final : public ITokenProducer {
 public:
     QuoteProducer() = default;
 
-    Token operator()(const std::string&) const override {
+    Token operator()(std::string_view) const override {
         return QuoteToken{};
     }
 };
 
+inline uint64_t ParseEightDigits(const char* digits) {
+    // SWAR: digit pairs, then quadruples, then the whole octet are combined by one multiplication
+    // each, the first digit is the lowest byte of a little endian word
+    uint64_t word;
+    std::memcpy(&word, digits, sizeof(word));
+    word -= 0x3030303030303030ULL;
+    word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+    word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFULL;
+    return (word * 10000 + (word >> 32)) & 0xFFFFFFFFULL;
+}
+
+inline uint64_t ParseDigits(std::string_view digits) {  // at most 19 digits, no overflow checks
+    uint64_t value = 0;
+    size_t i = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+        for (; i + 8 <= digits.size(); i += 8) {
+            value = value * 100000000 + ParseEightDigits(digits.data() + i);
+        }
+    }
+    for (; i < digits.size(); ++i) {
+        value = value * 10 + (digits[i] - '0');
+    }
+    return value;
+}
+
 class ConstantProducer final : public ITokenProducer {
 public:
     ConstantProducer() = default;
 
-    Token operator()(const std::string& token) const override {
-        return ConstantToken{std::atoll(token.data())};
+    Token operator()(std::string_view token) const override {
+        bool negative = token[0] == '-';
+        std::string_view digits = token.substr(negative || token[0] == '+' ? 1 : 0);
+        if (digits.size() <= kSafeDigitsCount) {
+            int64_t value = ParseDigits(digits);
+            return ConstantToken{negative ? -value : value};
+        }
+
+        int64_t value = 0;
+        const char* begin = token.data() + (token[0] == '+' ? 1 : 0);
+        auto [end, error] = std::from_chars(begin, token.data() + token.size(), value);
+        if (error == std::errc::result_out_of_range) {
+            return BigConstantToken{std::string(token)};
+        }
+        return ConstantToken{value};
+    }
+
+private:
+    constexpr static inline size_t kSafeDigitsCount = 18;  // any such literal fits into `int64_t`
+};
+
+class FloatProducer final : public ITokenProducer {
+public:
+    FloatProducer() = default;
+
+    Token operator()(std::string_view token) const override {
+        double value = 0;
+        const char* begin = token.data() + (token[0] == '+' ? 1 : 0);
+        auto [end, error] = std::from_chars(begin, token.data() + token.size(), value);
+        if (error == std::errc::result_out_of_range) {
+            value = std::strtod(std::string(token).c_str(), nullptr);  // infinity or zero
+        }
+        return FloatConstantToken{value};
+    }
+};
+
+class StringProducer final : public ITokenProducer {
+public:
+    StringProducer() = default;
+
+    Token operator()(std::string_view token) const override {
+        StringToken result;
+        result.value.reserve(token.size() - 2);
+        for (size_t i = 1; i + 1 < token.size(); ++i) {
+            if (token[i] != '\\') {
+                result.value += token[i];
+                continue;
+            }
+            ++i;
+            switch (token[i]) {
+                case 'n':
+                    result.value += '\n';
+                    break;
+                case 't':
+                    result.value += '\t';
+                    break;
+                default:
+                    result.value += token[i];  // `\"`, `\\` and unknown escapes
+            }
+        }
+        return result;
     }
 };
 
@@ -94,7 +207,7 @@ class SymbolProducer final : public ITokenProducer {
 public:
     SymbolProducer() = default;
 
-    Token operator()(const std::string& token) const override {
+    Token operator()(std::string_view token) const override {
         return SymbolToken{token};
     }
 };
\ No newline at end of file
@@ -0,0 +1,544 @@
+#include "vector_kernels.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_AVX2_KERNELS
+#endif
+
+namespace {
+
+template <class T>
+bool Satisfies(T value, KernelComparison comparison, T threshold) {
+    switch (comparison) {
+        case KernelComparison::Less:
+            return value < threshold;
+        case KernelComparison::Greater:
+            return value > threshold;
+        case KernelComparison::Equal:
+            return value == threshold;
+        case KernelComparison::LessEqual:
+            return value <= threshold;
+        case KernelComparison::GreaterEqual:
+            return value >= threshold;
+    }
+    return false;
+}
+
+namespace scalar {
+
+template <class T>
+T Sum(const T* data, size_t size) {
+    T result = 0;
+    for (size_t i = 0; i < size; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+double SumFloats(const double* data, size_t size) {
+    return Sum(data, size);
+}
+
+int64_t SumSmallIntegers(const int64_t* data, size_t size) {
+    return Sum(data, size);
+}
+
+double DotFloats(const double* lhs, const double* rhs, size_t size) {
+    double result = 0;
+    for (size_t i = 0; i < size; ++i) {
+        result += lhs[i] * rhs[i];
+    }
+    return result;
+}
+
+double MinFloats(const double* data, size_t size) {
+    return *std::min_element(data, data + size);
+}
+
+double MaxFloats(const double* data, size_t size) {
+    return *std::max_element(data, data + size);
+}
+
+int64_t MinIntegers(const int64_t* data, size_t size) {
+    return *std::min_element(data, data + size);
+}
+
+int64_t MaxIntegers(const int64_t* data, size_t size) {
+    return *std::max_element(data, data + size);
+}
+
+template <class T>
+void Add(T* lhs, const T* rhs, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        lhs[i] += rhs[i];
+    }
+}
+
+void AddFloats(double* lhs, const double* rhs, size_t size) {
+    Add(lhs, rhs, size);
+}
+
+void AddSmallIntegers(int64_t* lhs, const int64_t* rhs, size_t size) {
+    Add(lhs, rhs, size);
+}
+
+template <class T>
+void Scale(T* data, size_t size, T factor) {
+    for (size_t i = 0; i < size; ++i) {
+        data[i] *= factor;
+    }
+}
+
+void ScaleFloats(double* data, size_t size, double factor) {
+    Scale(data, size, factor);
+}
+
+void ScaleSmallIntegers(int64_t* data, size_t size, int64_t factor) {
+    Scale(data, size, factor);
+}
+
+template <class T>
+size_t Count(const T* data, size_t size, KernelComparison comparison, T threshold) {
+    size_t result = 0;
+    for (size_t i = 0; i < size; ++i) {
+        result += Satisfies(data[i], comparison, threshold);
+    }
+    return result;
+}
+
+size_t CountFloats(const double* data, size_t size, KernelComparison comparison,
+                   double threshold) {
+    return Count(data, size, comparison, threshold);
+}
+
+size_t CountIntegers(const int64_t* data, size_t size, KernelComparison comparison,
+                     int64_t threshold) {
+    return Count(data, size, comparison, threshold);
+}
+
+}  // namespace scalar
+
+#ifdef __SSE2__
+
+namespace sse2 {  // two lanes, 64-bit integer comparisons are not available until SSE4.2
+
+using scalar::MaxIntegers;
+using scalar::MinIntegers;
+using scalar::CountIntegers;
+using scalar::ScaleSmallIntegers;
+
+double Reduce(__m128d vector) {
+    return _mm_cvtsd_f64(_mm_add_sd(vector, _mm_unpackhi_pd(vector, vector)));
+}
+
+double SumFloats(const double* data, size_t size) {
+    __m128d result = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        result = _mm_add_pd(result, _mm_loadu_pd(data + i));
+    }
+    return Reduce(result) + scalar::SumFloats(data + i, size - i);
+}
+
+int64_t SumSmallIntegers(const int64_t* data, size_t size) {
+    __m128i result = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        result = _mm_add_epi64(result, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), result);
+    return lanes[0] + lanes[1] + scalar::SumSmallIntegers(data + i, size - i);
+}
+
+double DotFloats(const double* lhs, const double* rhs, size_t size) {
+    __m128d result = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        result = _mm_add_pd(result, _mm_mul_pd(_mm_loadu_pd(lhs + i), _mm_loadu_pd(rhs + i)));
+    }
+    return Reduce(result) + scalar::DotFloats(lhs + i, rhs + i, size - i);
+}
+
+double MinFloats(const double* data, size_t size) {
+    if (size < 2) {
+        return scalar::MinFloats(data, size);
+    }
+    __m128d result = _mm_loadu_pd(data);
+    size_t i = 2;
+    for (; i + 2 <= size; i += 2) {
+        result = _mm_min_pd(result, _mm_loadu_pd(data + i));
+    }
+    result = _mm_min_sd(result, _mm_unpackhi_pd(result, result));
+    return i < size ? std::min(_mm_cvtsd_f64(result), data[i]) : _mm_cvtsd_f64(result);
+}
+
+double MaxFloats(const double* data, size_t size) {
+    if (size < 2) {
+        return scalar::MaxFloats(data, size);
+    }
+    __m128d result = _mm_loadu_pd(data);
+    size_t i = 2;
+    for (; i + 2 <= size; i += 2) {
+        result = _mm_max_pd(result, _mm_loadu_pd(data + i));
+    }
+    result = _mm_max_sd(result, _mm_unpackhi_pd(result, result));
+    return i < size ? std::max(_mm_cvtsd_f64(result), data[i]) : _mm_cvtsd_f64(result);
+}
+
+void AddFloats(double* lhs, const double* rhs, size_t size) {
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        _mm_storeu_pd(lhs + i, _mm_add_pd(_mm_loadu_pd(lhs + i), _mm_loadu_pd(rhs + i)));
+    }
+    scalar::AddFloats(lhs + i, rhs + i, size - i);
+}
+
+void AddSmallIntegers(int64_t* lhs, const int64_t* rhs, size_t size) {
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        __m128i* lhs_ptr = reinterpret_cast<__m128i*>(lhs + i);
+        __m128i rhs_vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+        _mm_storeu_si128(lhs_ptr, _mm_add_epi64(_mm_loadu_si128(lhs_ptr), rhs_vector));
+    }
+    scalar::AddSmallIntegers(lhs + i, rhs + i, size - i);
+}
+
+void ScaleFloats(double* data, size_t size, double factor) {
+    __m128d factor_vector = _mm_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        _mm_storeu_pd(data + i, _mm_mul_pd(_mm_loadu_pd(data + i), factor_vector));
+    }
+    scalar::ScaleFloats(data + i, size - i, factor);
+}
+
+__m128d CompareFloats(__m128d lhs, KernelComparison comparison, __m128d rhs) {
+    switch (comparison) {
+        case KernelComparison::Less:
+            return _mm_cmplt_pd(lhs, rhs);
+        case KernelComparison::Greater:
+            return _mm_cmpgt_pd(lhs, rhs);
+        case KernelComparison::Equal:
+            return _mm_cmpeq_pd(lhs, rhs);
+        case KernelComparison::LessEqual:
+            return _mm_cmple_pd(lhs, rhs);
+        case KernelComparison::GreaterEqual:
+            return _mm_cmpge_pd(lhs, rhs);
+    }
+    return _mm_setzero_pd();
+}
+
+size_t CountFloats(const double* data, size_t size, KernelComparison comparison,
+                   double threshold) {
+    __m128d threshold_vector = _mm_set1_pd(threshold);
+    size_t result = 0;
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        __m128d mask = CompareFloats(_mm_loadu_pd(data + i), comparison, threshold_vector);
+        result += std::popcount(static_cast<unsigned>(_mm_movemask_pd(mask)));
+    }
+    return result + scalar::CountFloats(data + i, size - i, comparison, threshold);
+}
+
+}  // namespace sse2
+
+#else
+
+namespace sse2 = scalar;
+
+#endif
+
+#ifdef HAS_AVX2_KERNELS
+
+namespace avx2 {  // four lanes, compiled for AVX2 regardless of the target and called only on it
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET double Reduce(__m256d vector) {
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(vector), _mm256_extractf128_pd(vector, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+AVX2_TARGET __m256i Load(const int64_t* data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+}
+
+AVX2_TARGET void Store(int64_t* data, __m256i vector) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), vector);
+}
+
+AVX2_TARGET double SumFloats(const double* data, size_t size) {
+    __m256d result = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        result = _mm256_add_pd(result, _mm256_loadu_pd(data + i));
+    }
+    return Reduce(result) + scalar::SumFloats(data + i, size - i);
+}
+
+AVX2_TARGET int64_t SumSmallIntegers(const int64_t* data, size_t size) {
+    __m256i result = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        result = _mm256_add_epi64(result, Load(data + i));
+    }
+    int64_t lanes[4];
+    Store(lanes, result);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+           scalar::SumSmallIntegers(data + i, size - i);
+}
+
+AVX2_TARGET double DotFloats(const double* lhs, const double* rhs, size_t size) {
+    __m256d result = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        result = _mm256_add_pd(result,
+                               _mm256_mul_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i)));
+    }
+    return Reduce(result) + scalar::DotFloats(lhs + i, rhs + i, size - i);
+}
+
+AVX2_TARGET double MinFloats(const double* data, size_t size) {
+    if (size < 4) {
+        return scalar::MinFloats(data, size);
+    }
+    __m256d result = _mm256_loadu_pd(data);
+    size_t i = 4;
+    for (; i + 4 <= size; i += 4) {
+        result = _mm256_min_pd(result, _mm256_loadu_pd(data + i));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, result);
+    double value = scalar::MinFloats(lanes, 4);
+    return i < size ? std::min(value, scalar::MinFloats(data + i, size - i)) : value;
+}
+
+AVX2_TARGET double MaxFloats(const double* data, size_t size) {
+    if (size < 4) {
+        return scalar::MaxFloats(data, size);
+    }
+    __m256d result = _mm256_loadu_pd(data);
+    size_t i = 4;
+    for (; i + 4 <= size; i += 4) {
+        result = _mm256_max_pd(result, _mm256_loadu_pd(data + i));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, result);
+    double value = scalar::MaxFloats(lanes, 4);
+    return i < size ? std::max(value, scalar::MaxFloats(data + i, size - i)) : value;
+}
+
+AVX2_TARGET int64_t MinIntegers(const int64_t* data, size_t size) {
+    if (size < 4) {
+        return scalar::MinIntegers(data, size);
+    }
+    __m256i result = Load(data);
+    size_t i = 4;
+    for (; i + 4 <= size; i += 4) {
+        __m256i next = Load(data + i);
+        result = _mm256_blendv_epi8(result, next, _mm256_cmpgt_epi64(result, next));
+    }
+    int64_t lanes[4];
+    Store(lanes, result);
+    int64_t value = scalar::MinIntegers(lanes, 4);
+    return i < size ? std::min(value, scalar::MinIntegers(data + i, size - i)) : value;
+}
+
+AVX2_TARGET int64_t MaxIntegers(const int64_t* data, size_t size) {
+    if (size < 4) {
+        return scalar::MaxIntegers(data, size);
+    }
+    __m256i result = Load(data);
+    size_t i = 4;
+    for (; i + 4 <= size; i += 4) {
+        __m256i next = Load(data + i);
+        result = _mm256_blendv_epi8(result, next, _mm256_cmpgt_epi64(next, result));
+    }
+    int64_t lanes[4];
+    Store(lanes, result);
+    int64_t value = scalar::MaxIntegers(lanes, 4);
+    return i < size ? std::max(value, scalar::MaxIntegers(data + i, size - i)) : value;
+}
+
+AVX2_TARGET void AddFloats(double* lhs, const double* rhs, size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(lhs + i,
+                         _mm256_add_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i)));
+    }
+    scalar::AddFloats(lhs + i, rhs + i, size - i);
+}
+
+AVX2_TARGET void AddSmallIntegers(int64_t* lhs, const int64_t* rhs, size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        Store(lhs + i, _mm256_add_epi64(Load(lhs + i), Load(rhs + i)));
+    }
+    scalar::AddSmallIntegers(lhs + i, rhs + i, size - i);
+}
+
+AVX2_TARGET void ScaleFloats(double* data, size_t size, double factor) {
+    __m256d factor_vector = _mm256_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(data + i, _mm256_mul_pd(_mm256_loadu_pd(data + i), factor_vector));
+    }
+    scalar::ScaleFloats(data + i, size - i, factor);
+}
+
+AVX2_TARGET void ScaleSmallIntegers(int64_t* data, size_t size, int64_t factor) {
+    // products of sign extended 32-bit values are exact in 64-bit lanes
+    __m256i factor_vector = _mm256_set1_epi64x(factor);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        Store(data + i, _mm256_mul_epi32(Load(data + i), factor_vector));
+    }
+    scalar::ScaleSmallIntegers(data + i, size - i, factor);
+}
+
+AVX2_TARGET size_t CountMask(__m256i mask) {
+    return std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))));
+}
+
+AVX2_TARGET size_t CountFloats(const double* data, size_t size, KernelComparison comparison,
+                               double threshold) {
+    __m256d threshold_vector = _mm256_set1_pd(threshold);
+    size_t result = 0;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256d value = _mm256_loadu_pd(data + i);
+        __m256d mask;
+        switch (comparison) {  // predicate of `_mm256_cmp_pd` must be a constant
+            case KernelComparison::Less:
+                mask = _mm256_cmp_pd(value, threshold_vector, _CMP_LT_OQ);
+                break;
+            case KernelComparison::Greater:
+                mask = _mm256_cmp_pd(value, threshold_vector, _CMP_GT_OQ);
+                break;
+            case KernelComparison::Equal:
+                mask = _mm256_cmp_pd(value, threshold_vector, _CMP_EQ_OQ);
+                break;
+            case KernelComparison::LessEqual:
+                mask = _mm256_cmp_pd(value, threshold_vector, _CMP_LE_OQ);
+                break;
+            default:
+                mask = _mm256_cmp_pd(value, threshold_vector, _CMP_GE_OQ);
+                break;
+        }
+        result += CountMask(_mm256_castpd_si256(mask));
+    }
+    return result + scalar::CountFloats(data + i, size - i, comparison, threshold);
+}
+
+AVX2_TARGET size_t CountIntegers(const int64_t* data, size_t size, KernelComparison comparison,
+                                 int64_t threshold) {
+    __m256i threshold_vector = _mm256_set1_epi64x(threshold);
+    size_t result = 0;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i value = Load(data + i);
+        switch (comparison) {  // non-strict comparisons count complements of strict ones
+            case KernelComparison::Less:
+                result += CountMask(_mm256_cmpgt_epi64(threshold_vector, value));
+                break;
+            case KernelComparison::Greater:
+                result += CountMask(_mm256_cmpgt_epi64(value, threshold_vector));
+                break;
+            case KernelComparison::Equal:
+                result += CountMask(_mm256_cmpeq_epi64(value, threshold_vector));
+                break;
+            case KernelComparison::LessEqual:
+                result += 4 - CountMask(_mm256_cmpgt_epi64(value, threshold_vector));
+                break;
+            case KernelComparison::GreaterEqual:
+                result += 4 - CountMask(_mm256_cmpgt_epi64(threshold_vector, value));
+                break;
+        }
+    }
+    return result + scalar::CountIntegers(data + i, size - i, comparison, threshold);
+}
+
+#undef AVX2_TARGET
+
+}  // namespace avx2
+
+#else
+
+namespace avx2 = sse2;
+
+#endif
+
+}  // namespace
+
+bool HasAvx2() {
+#ifdef HAS_AVX2_KERNELS
+    static const bool kHasAvx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }();
+    return kHasAvx2;
+#else
+    return false;
+#endif
+}
+
+double SumFloats(const double* data, size_t size) {
+    return HasAvx2() ? avx2::SumFloats(data, size) : sse2::SumFloats(data, size);
+}
+
+int64_t SumSmallIntegers(const int64_t* data, size_t size) {
+    return HasAvx2() ? avx2::SumSmallIntegers(data, size) : sse2::SumSmallIntegers(data, size);
+}
+
+double DotFloats(const double* lhs, const double* rhs, size_t size) {
+    return HasAvx2() ? avx2::DotFloats(lhs, rhs, size) : sse2::DotFloats(lhs, rhs, size);
+}
+
+double MinFloats(const double* data, size_t size) {
+    return HasAvx2() ? avx2::MinFloats(data, size) : sse2::MinFloats(data, size);
+}
+
+double MaxFloats(const double* data, size_t size) {
+    return HasAvx2() ? avx2::MaxFloats(data, size) : sse2::MaxFloats(data, size);
+}
+
+int64_t MinIntegers(const int64_t* data, size_t size) {
+    return HasAvx2() ? avx2::MinIntegers(data, size) : sse2::MinIntegers(data, size);
+}
+
+int64_t MaxIntegers(const int64_t* data, size_t size) {
+    return HasAvx2() ? avx2::MaxIntegers(data, size) : sse2::MaxIntegers(data, size);
+}
+
+void AddFloats(double* lhs, const double* rhs, size_t size) {
+    HasAvx2() ? avx2::AddFloats(lhs, rhs, size) : sse2::AddFloats(lhs, rhs, size);
+}
+
+void AddSmallIntegers(int64_t* lhs, const int64_t* rhs, size_t size) {
+    HasAvx2() ? avx2::AddSmallIntegers(lhs, rhs, size) : sse2::AddSmallIntegers(lhs, rhs, size);
+}
+
+void ScaleFloats(double* data, size_t size, double factor) {
+    HasAvx2() ? avx2::ScaleFloats(data, size, factor) : sse2::ScaleFloats(data, size, factor);
+}
+
+void ScaleSmallIntegers(int64_t* data, size_t size, int64_t factor) {
+    HasAvx2() ? avx2::ScaleSmallIntegers(data, size, factor)
+              : sse2::ScaleSmallIntegers(data, size, factor);
+}
+
+size_t CountFloats(const double* data, size_t size, KernelComparison comparison,
+                   double threshold) {
+    return HasAvx2() ? avx2::CountFloats(data, size, comparison, threshold)
+                     : sse2::CountFloats(data, size, comparison, threshold);
+}
+
+size_t CountIntegers(const int64_t* data, size_t size, KernelComparison comparison,
+                     int64_t threshold) {
+    return HasAvx2() ? avx2::CountIntegers(data, size, comparison, threshold)
+                     : sse2::CountIntegers(data, size, comparison, threshold);
+}
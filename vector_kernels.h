@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+    Numeric kernels over unboxed contiguous arrays. Every kernel picks AVX2 or SSE2 implementation
+    by the CPU it runs on and falls back to a scalar loop elsewhere. Floating point sums are
+    reassociated across lanes, so the last bits may differ from a left fold
+*/
+
+bool HasAvx2();  // checked once, the tokenizer scanning kernels dispatch on it as well
+
+enum class KernelComparison { Less, Greater, Equal, LessEqual, GreaterEqual };
+
+double SumFloats(const double* data, size_t size);
+
+int64_t SumSmallIntegers(const int64_t* data, size_t size);  // every value fits in 32 bits
+
+double DotFloats(const double* lhs, const double* rhs, size_t size);
+
+double MinFloats(const double* data, size_t size);  // size is positive
+
+double MaxFloats(const double* data, size_t size);  // size is positive
+
+int64_t MinIntegers(const int64_t* data, size_t size);  // size is positive
+
+int64_t MaxIntegers(const int64_t* data, size_t size);  // size is positive
+
+void AddFloats(double* lhs, const double* rhs, size_t size);  // lhs[i] += rhs[i]
+
+void AddSmallIntegers(int64_t* lhs, const int64_t* rhs, size_t size);  // both fit in 32 bits
+
+void ScaleFloats(double* data, size_t size, double factor);
+
+void ScaleSmallIntegers(int64_t* data, size_t size, int64_t factor);  // all fit in 32 bits
+
+size_t CountFloats(const double* data, size_t size, KernelComparison comparison,
+                   double threshold);  // elements `x` such that `x <comparison> threshold`
+
+size_t CountIntegers(const int64_t* data, size_t size, KernelComparison comparison,
+                     int64_t threshold);